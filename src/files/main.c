@@ -1,43 +1,132 @@
 #include <stdio.h>
+#include <string.h>
+#ifdef __APPLE__
 #include <CoreGraphics/CoreGraphics.h>
+#endif
 #include "MQueue.h"
 #include "MInterpreter.h"
+#include "MSim.h"
+#include "MLoader.h"
 #include <signal.h>
-volatile sig_atomic_t running = 1; 
+#include <unistd.h>
+volatile sig_atomic_t running = 1;
 
-void handle_sigint(int sig) {
-    printf("\nCaught Ctrl-C (SIGINT), exiting...\n");
-    running = 0; 
+void handle_signal(int sig) {
+    static const char msg[] = "\nCaught SIGINT/SIGTERM, exiting...\n";
+    (void)sig;
+    write(STDERR_FILENO, msg, sizeof(msg) - 1);
+    running = 0;
 }
-int main() {
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "usage: %s [options] [script | dir | list.manifest]\n"
+            "       %s [options] --simulate script|dir|list.manifest keys.txt [golden.trace]\n"
+            "options:\n"
+            "  --profile[=out.folded]  count and time hotkeys, commands and posted events\n"
+            "  --profile-every=N       time only one in N executions (implies --profile)\n"
+            "  --lenient               run despite parse errors and duplicate definitions\n",
+            prog, prog);
+}
+
+int main(int argc, char **argv) {
+    const char *script_path = "/Users/codinggenius/MacHK/src/files/test_script/script.msr";
+    const char *keys_path = NULL;
+    const char *golden_path = NULL;
+    const char *profile_path = MPROF_DEFAULT_PATH;
+    int simulate = 0;
+    int lenient = 0;
+
+    int arg = 1;
+    for (; arg < argc && strncmp(argv[arg], "--", 2) == 0; arg++) {
+        if (strcmp(argv[arg], "--simulate") == 0) {
+            simulate = 1;
+        } else if (strcmp(argv[arg], "--lenient") == 0) {
+            lenient = 1;
+        } else if (strcmp(argv[arg], "--profile") == 0) {
+            MProfiler.enabled = 1;
+        } else if (strncmp(argv[arg], "--profile=", 10) == 0) {
+            MProfiler.enabled = 1;
+            profile_path = argv[arg] + 10;
+        } else if (strncmp(argv[arg], "--profile-every=", 16) == 0) {
+            int every = atoi(argv[arg] + 16);
+            MProfiler.enabled = 1;
+            MProfiler.sample_every = every > 0 ? (uint32_t)every : 1;
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    int positional = argc - arg;
+    if (simulate) {
+        if (positional < 2 || positional > 3) { usage(argv[0]); return 2; }
+        script_path = argv[arg];
+        keys_path = argv[arg + 1];
+        golden_path = positional == 3 ? argv[arg + 2] : NULL;
+    } else if (positional == 1) {
+        script_path = argv[arg];
+    } else if (positional > 1) {
+        usage(argv[0]);
+        return 2;
+    }
+
     init_globals();
-    MFile mf = read_file("/Users/codinggenius/MacHK/src/files/test_script/script.msr");
-    MScript script = parse_script(&mf);
-    print_script(&script);
-    print_vars();
-    CGEventMask mask = CGEventMaskBit(kCGEventKeyDown);
-    CFMachPortRef tap = CGEventTapCreate(
-        kCGSessionEventTap,
-        kCGHeadInsertEventTap,
-        kCGEventTapOptionDefault,
-        mask,
-        hotkey_callback,
-        &script
-    );
-
-    if (!tap) { fprintf(stderr, "Failed to create event tap\n"); return 1; }
-
-    CFRunLoopAddSource(CFRunLoopGetCurrent(), CFMachPortCreateRunLoopSource(kCFAllocatorDefault, tap, 0), kCFRunLoopCommonModes);
-    CGEventTapEnable(tap, true);
-
-    while(running)
-    {
-        CFRunLoopRunInMode(kCFRunLoopDefaultMode, 0.1, true);
-        process();
+    MScript script;
+    size_t unreadable = 0;
+    size_t problems = load_scripts(script_path, &script, &unreadable);
+    if (!script.file_count) return 1;
+
+    int status = 0;
+    int loaded = !unreadable && (!problems || lenient);
+    if (!loaded) {
+        fprintf(stderr, "%zu problems loading %s%s\n", problems, script_path,
+                unreadable ? "" : " (--lenient runs anyway)");
+        status = 1;
+    } else if (keys_path) {
+        status = run_simulation(&script, keys_path, golden_path);
+    } else {
+        print_script(&script);
+        print_vars();
+#ifdef __APPLE__
+        CGEventMask mask = CGEventMaskBit(kCGEventKeyDown);
+        CFMachPortRef tap = CGEventTapCreate(
+            kCGSessionEventTap,
+            kCGHeadInsertEventTap,
+            kCGEventTapOptionDefault,
+            mask,
+            hotkey_callback,
+            &script
+        );
+
+        if (!tap) { fprintf(stderr, "Failed to create event tap\n"); return 1; }
+        signal(SIGINT, handle_signal);
+        signal(SIGTERM, handle_signal);
+
+        CFRunLoopAddSource(CFRunLoopGetCurrent(), CFMachPortCreateRunLoopSource(kCFAllocatorDefault, tap, 0), kCFRunLoopCommonModes);
+        CGEventTapEnable(tap, true);
+
+        uint64_t flushed_ns = prof_now_ns();
+        while(running)
+        {
+            CFRunLoopRunInMode(kCFRunLoopDefaultMode, M_RUNLOOP_INTERVAL, true);
+            process();
+            if (MProfiler.enabled && prof_now_ns() - flushed_ns >= MPROF_FLUSH_SECONDS * 1000000000ull) {
+                write_profile(&script, profile_path, 0);
+                flushed_ns = prof_now_ns();
+            }
+        }
+#else
+        fprintf(stderr, "Live hotkeys need macOS; only --simulate is available here\n");
+        status = 2;
+#endif
     }
 
+    if (MProfiler.enabled && loaded) write_profile(&script, profile_path, 1);
+
     free_script(&script);
-    free_mfile(&mf);
     destroy_nodes();
-    return 0;
-}
\ No newline at end of file
+    free_vars();
+    free_interns();
+    return status;
+}
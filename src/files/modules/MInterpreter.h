@@ -1,16 +1,20 @@
 #ifndef MINTERPRETER_H
 #define MINTERPRETER_H
 #define MAX_STACK 256
-#define MAX_VARS 256
+
+#include "MValue.h"
 
 typedef struct {
-    char name[32];
-    int value;
+    const char *name; // interned
+    MValue value;
 } MVar;
 
+// Frames grow as needed and keep their storage when popped, so a hotkey only
+// allocates the first time it reaches a new depth or variable count.
 typedef struct {
-    MVar vars[MAX_VARS];
+    MVar *vars;
     int count;
+    int capacity;
 } MVarFrame;
 
 
@@ -28,117 +32,118 @@ static void push_frame() {
 }
 
 static void pop_frame() {
-    if (vsp > 0) vsp--;
+    if (vsp <= 0) return;
+    for (int j = 0; j < vstack[vsp].count; j++) value_release(vstack[vsp].vars[j].value);
+    vsp--;
 }
 
-static int* find_var(const char *name) {
+// Releases every variable, globals included.
+static void free_vars() {
+    for (int i = vsp; i >= 0; i--) {
+        for (int j = 0; j < vstack[i].count; j++) value_release(vstack[i].vars[j].value);
+        vstack[i].count = 0;
+    }
+    for (int i = 0; i < MAX_STACK; i++) {
+        free(vstack[i].vars);
+        vstack[i].vars = NULL;
+        vstack[i].capacity = 0;
+    }
+}
+
+static MValue* find_var_interned(const char *name) {
     for (int i = vsp; i >= 1; i--) {
         for (int j = 0; j < vstack[i].count; j++) {
-            if (strcmp(vstack[i].vars[j].name, name) == 0)
+            if (vstack[i].vars[j].name == name)
                 return &vstack[i].vars[j].value;
         }
     }
 
     for (int j = 0; j < vstack[0].count; j++) {
-        if (strcmp(vstack[0].vars[j].name, name) == 0)
+        if (vstack[0].vars[j].name == name)
             return &vstack[0].vars[j].value;
     }
 
     return NULL;
 }
+
 static void print_vars() {
     printf("=== VARIABLES ===\n");
     printf("[globals]\n");
     for (int j = 0; j < vstack[0].count; j++) {
-        printf("  %s = %d\n",
-               vstack[0].vars[j].name,
-               vstack[0].vars[j].value);
+        printf("  %s = ", vstack[0].vars[j].name);
+        print_value(vstack[0].vars[j].value);
+        printf("\n");
     }
     for (int i = 1; i <= vsp; i++) {
         printf("[frame %d]\n", i);
         for (int j = 0; j < vstack[i].count; j++) {
-            printf("  %s = %d\n",
-                   vstack[i].vars[j].name,
-                   vstack[i].vars[j].value);
+            printf("  %s = ", vstack[i].vars[j].name);
+            print_value(vstack[i].vars[j].value);
+            printf("\n");
         }
     }
 
     printf("=================\n");
 }
 
-static void set_var(const char *name, int value) {
-    for (int i = vsp; i >= 1; i--) {
-        for (int j = 0; j < vstack[i].count; j++) {
-            if (strcmp(vstack[i].vars[j].name, name) == 0) {
-                vstack[i].vars[j].value = value;
-                return;
-            }
-        }
-    }
-    for (int j = 0; j < vstack[0].count; j++) {
-        if (strcmp(vstack[0].vars[j].name, name) == 0) {
-            vstack[0].vars[j].value = value;
-            return;
-        }
+// Returns 0 (and releases value) if the frame could not grow.
+static int frame_add(MVarFrame *f, const char *iname, MValue value) {
+    if (f->count == f->capacity) {
+        int capacity = f->capacity ? f->capacity * 2 : 16;
+        MVar *vars = (MVar*)realloc(f->vars, capacity * sizeof(MVar));
+        if (!vars) { value_release(value); return 0; }
+        f->vars = vars;
+        f->capacity = capacity;
     }
-    int target = (vsp >= 1) ? vsp : 0;
-    MVarFrame *f = &vstack[target];
-
-    strcpy(f->vars[f->count].name, name);
+    f->vars[f->count].name = iname;
     f->vars[f->count].value = value;
     f->count++;
+    return 1;
 }
-static void set_global_var(const char *name, int value) {
+
+static int set_var_interned(const char *iname, MValue value) {
+    MValue *existing = find_var_interned(iname);
+    if (existing) {
+        value_release(*existing);
+        *existing = value;
+        return 1;
+    }
+    int target = (vsp >= 1) ? vsp : 0;
+    return frame_add(&vstack[target], iname, value);
+}
+static int set_global_var_interned(const char *iname, MValue value) {
     for (int j = 0; j < vstack[0].count; j++) {
-        if (strcmp(vstack[0].vars[j].name, name) == 0) {
+        if (vstack[0].vars[j].name == iname) {
+            value_release(vstack[0].vars[j].value);
             vstack[0].vars[j].value = value;
-            return;
+            return 1;
         }
     }
+    return frame_add(&vstack[0], iname, value);
+}
 
-    MVarFrame *f = &vstack[0];
-    strcpy(f->vars[f->count].name, name);
-    f->vars[f->count].value = value;
-    f->count++;
+static int set_var(const char *name, MValue value) {
+    const char *iname = intern(name);
+    if (iname) return set_var_interned(iname, value);
+    value_release(value);
+    return 0;
+}
+static int set_global_var(const char *name, MValue value) {
+    const char *iname = intern(name);
+    if (iname) return set_global_var_interned(iname, value);
+    value_release(value);
+    return 0;
 }
 
 
-#include <ApplicationServices/ApplicationServices.h>
+#include "MPlatform.h"
+#include "MKeys.h"
+#include "MProfile.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
-
-typedef struct {
-    const char *name;
-    CGKeyCode code;
-} KeyLookup;
-
-static KeyLookup key_table[] = {
-    {"A", 0}, {"S", 1}, {"D", 2}, {"F", 3},
-    {"H", 4}, {"G", 5}, {"Z", 6}, {"X", 7},
-    {"C", 8}, {"V", 9}, {"B", 11}, {"Q", 12},
-    {"W", 13}, {"E", 14}, {"R", 15}, {"Y", 16},
-    {"T", 17}, {"1", 18}, {"2", 19}, {"3", 20},
-    {"4", 21}, {"6", 22}, {"5", 23}, {"=", 24},
-    {"9", 25}, {"7", 26}, {"-", 27}, {"8", 28},
-    {"0", 29}, {"RightBracket", 30}, {"O", 31}, {"U", 32},
-    {"LeftBracket", 33}, {"I", 34}, {"P", 35}, {"L", 37},
-    {"J", 38}, {"'", 39}, {"K", 40}, {";", 41},
-    {"\\", 42}, {",", 43}, {"/", 44}, {"N", 45},
-    {"M", 46}, {".", 47}, {"Tab", 48}, {"Space", 49},
-    {"Backtick", 50}, {"Escape", 53},
-    {"F1", 122}, {"F2", 120}, {"F3", 99}, {"F4", 118},
-    {"F5", 96}, {"F6", 97}, {"F7", 98}, {"F8", 100},
-    {"F9", 101}, {"F10", 109}, {"F11", 103}, {"F12", 111}
-};
-
-static CGKeyCode get_keycode(const char *key) {
-    for (size_t i = 0; i < sizeof(key_table)/sizeof(key_table[0]); i++) {
-        if (strcmp(key, key_table[i].name) == 0) return key_table[i].code;
-    }
-    return UINT16_MAX;
-}
+#include <stdarg.h>
 
 typedef struct {
     char **lines;
@@ -195,46 +200,366 @@ static void free_mfile(MFile *mf) {
 
 typedef enum { _cmd_iter(htypes_enum) } MCommandType;
 
+// Expressions are compiled once after load into postfix ops; literals and
+// variable names are interned at that point, so running one never hashes.
+#define _op_iter(_F, ...)            \
+    _F(Const, 0, __VA_ARGS__)        \
+    _F(Var, 1, __VA_ARGS__)          \
+    _F(Neg, 2, __VA_ARGS__)          \
+    _F(Eq, 3, __VA_ARGS__)           \
+    _F(Ne, 4, __VA_ARGS__)           \
+    _F(Add, '+', __VA_ARGS__)        \
+    _F(Sub, '-', __VA_ARGS__)        \
+    _F(Mul, '*', __VA_ARGS__)        \
+    _F(Div, '/', __VA_ARGS__)        \
+
+#define optypes_enum(name, val, ...) MOp_##name = val,
+
+typedef enum { _op_iter(optypes_enum) } MOpType;
+
+#define MEXPR_MAX_DEPTH 64
+
+typedef struct {
+    MOpType op;
+    union {
+        MValue value;       // Const, interned if a string
+        const char *name;   // Var, interned
+    };
+} MExprOp;
+
+typedef struct {
+    MExprOp *ops;
+    size_t count;
+    int depth;
+} MExpr;
+
 typedef struct CursorMove { 
     char expr_x[32]; 
     char expr_y[32]; 
     float duration; 
+    MExpr x, y;
 } CursorMove_t;
 
-typedef struct KeyPress   { char key; } KeyPress_t;
-typedef struct KeyRelease { char key; } KeyRelease_t;
+typedef struct KeyPress   { CGKeyCode key; } KeyPress_t;
+typedef struct KeyRelease { CGKeyCode key; } KeyRelease_t;
 typedef struct HMouseClick { 
     char expr_x[32]; 
     char expr_y[32]; 
-    float clickType;
+    CGMouseButton clickType;
+    MExpr x, y;
 } HMouseClick_t;
-typedef struct SetVar { char name[32]; char expr[64]; } SetVar_t;
-static int eval_expr(const char *expr) {
-    char buf[64];
-    strcpy(buf, expr);
-
-    char *t = strtok(buf, " ");
-    int result = 0;
-    char op = 0;
-
-    while (t) {
-        int val = 0;
-        if (isdigit(*t) || (*t == '-' && isdigit(t[1]))) {
-            val = atoi(t);
-        } else {
-            int *v = find_var(t);
-            val = v ? *v : 0;
+typedef struct SetVar {
+    char name[32];
+    char expr[128];
+    const char *iname; // interned name
+    MExpr value;
+} SetVar_t;
+
+// With expr NULL the compiler only checks syntax: nothing is allocated or
+// interned, so parse_script() can run it on the loader threads.
+typedef struct {
+    MExpr *expr;
+    int sp;
+    int depth;
+    const char *error; // first error, NULL if none
+} MCompiler;
+
+static void compile_sum(MCompiler *c, const char **p);
+
+static void skip_spaces(const char **p) {
+    while (**p && isspace((unsigned char)**p)) (*p)++;
+}
+
+static void compile_fail(MCompiler *c, const char *error) {
+    if (!c->error) c->error = error;
+}
+
+// Pushes are tracked to size the run stack; pops are implied by the op.
+static void emit_op(MCompiler *c, MExprOp op) {
+    if (op.op == MOp_Const || op.op == MOp_Var) c->sp++;
+    else if (op.op != MOp_Neg) c->sp--;
+    if (c->sp > c->depth) c->depth = c->sp;
+    if (c->depth > MEXPR_MAX_DEPTH) { compile_fail(c, "nested too deeply"); return; }
+
+    MExpr *e = c->expr;
+    if (!e) return;
+    MExprOp *ops = (MExprOp*)realloc(e->ops, (e->count + 1) * sizeof(MExprOp));
+    if (!ops) { compile_fail(c, "out of memory"); return; }
+    e->ops = ops;
+    e->ops[e->count++] = op;
+}
+
+static void emit_const(MCompiler *c, MValue v) {
+    MExprOp op;
+    op.op = MOp_Const;
+    op.value = v;
+    emit_op(c, op);
+}
+
+static void compile_string_literal(MCompiler *c, const char **p) {
+    char buf[128];
+    size_t n = 0;
+    (*p)++;
+    while (**p && **p != '"') {
+        char ch = *(*p)++;
+        if (ch == '\\' && **p) {
+            ch = *(*p)++;
+            if (ch == 'n') ch = '\n';
+            else if (ch == 't') ch = '\t';
         }
+        if (n < sizeof(buf) - 1) buf[n++] = ch;
+    }
+    if (**p != '"') { compile_fail(c, "unterminated string"); return; }
+    (*p)++;
+    emit_const(c, c->expr ? value_str(intern_n(buf, n)) : value_int(0));
+}
+
+static void compile_operand(MCompiler *c, const char **p) {
+    if (c->error) return;
+    skip_spaces(p);
+    const char *s = *p;
+
+    if (*s == '(') {
+        (*p)++;
+        compile_sum(c, p);
+        skip_spaces(p);
+        if (**p == ')') (*p)++;
+        else compile_fail(c, "missing ')'");
+        return;
+    }
+    if (*s == '"') { compile_string_literal(c, p); return; }
+    if (*s == '-' && !isdigit((unsigned char)s[1]) && s[1] != '.') {
+        (*p)++;
+        compile_operand(c, p);
+        MExprOp op;
+        op.op = MOp_Neg;
+        emit_op(c, op);
+        return;
+    }
+    if (isdigit((unsigned char)*s) || *s == '.' || *s == '-') {
+        char *end;
+        long long i = strtoll(s, &end, 10);
+        if (*end == '.' || *end == 'e' || *end == 'E') {
+            double f = strtod(s, &end);
+            if (end == s) { compile_fail(c, "expected a value"); return; }
+            *p = end;
+            emit_const(c, value_float(f));
+            return;
+        }
+        if (end == s) { compile_fail(c, "expected a value"); return; }
+        *p = end;
+        emit_const(c, value_int(i));
+        return;
+    }
+    if (isalpha((unsigned char)*s) || *s == '_') {
+        while (isalnum((unsigned char)**p) || **p == '_') (*p)++;
+        size_t len = *p - s;
+        if (len == 4 && strncmp(s, "true", 4) == 0) { emit_const(c, value_bool(1)); return; }
+        if (len == 5 && strncmp(s, "false", 5) == 0) { emit_const(c, value_bool(0)); return; }
+
+        MExprOp op;
+        op.op = MOp_Var;
+        op.name = NULL;
+        if (c->expr && !(op.name = intern_n(s, len))) { compile_fail(c, "out of memory"); return; }
+        emit_op(c, op);
+        return;
+    }
+
+    compile_fail(c, "expected a value");
+}
 
-        if (!op) result = val;
-        else if (op == '+') result += val;
-        else if (op == '-') result -= val;
+static void compile_product(MCompiler *c, const char **p) {
+    compile_operand(c, p);
+    for (;;) {
+        skip_spaces(p);
+        char op = **p;
+        if (c->error || (op != '*' && op != '/')) return;
+        (*p)++;
+        compile_operand(c, p);
+        MExprOp o;
+        o.op = (MOpType)op;
+        emit_op(c, o);
+    }
+}
 
-        t = strtok(NULL, " ");
-        if (t) { op = *t; t = strtok(NULL, " "); }
+static void compile_sum(MCompiler *c, const char **p) {
+    compile_product(c, p);
+    for (;;) {
+        skip_spaces(p);
+        char op = **p;
+        if (c->error || (op != '+' && op != '-')) return;
+        (*p)++;
+        compile_product(c, p);
+        MExprOp o;
+        o.op = (MOpType)op;
+        emit_op(c, o);
     }
+}
 
-    return result;
+static void free_expr(MExpr *e) {
+    free(e->ops);
+    e->ops = NULL;
+    e->count = 0;
+    e->depth = 0;
+}
+
+// Returns NULL on success, or why text is not a valid expression. On failure
+// e is left empty and evaluates to 0. Pass e = NULL to only check syntax.
+static const char *compile_expr(const char *text, MExpr *e) {
+    if (e) memset(e, 0, sizeof(MExpr));
+    MCompiler c = { e, 0, 0, NULL };
+    const char *p = text;
+    compile_sum(&c, &p);
+    skip_spaces(&p);
+    if ((p[0] == '=' || p[0] == '!') && p[1] == '=') {
+        MOpType op = p[0] == '!' ? MOp_Ne : MOp_Eq;
+        p += 2;
+        compile_sum(&c, &p);
+        MExprOp o;
+        o.op = op;
+        emit_op(&c, o);
+        skip_spaces(&p);
+    }
+    if (*p) compile_fail(&c, *p == ')' ? "unmatched ')'" : "unexpected text after expression");
+    if (e) {
+        if (c.error) free_expr(e);
+        else e->depth = c.depth;
+    }
+    return c.error;
+}
+
+static MValue run_expr(const MExpr *e) {
+    MValue stack[MEXPR_MAX_DEPTH];
+    int sp = 0;
+
+    for (size_t i = 0; i < e->count; i++) {
+        const MExprOp *op = &e->ops[i];
+        switch (op->op) {
+            case MOp_Const:
+                stack[sp++] = op->value;
+                break;
+
+            case MOp_Var: {
+                MValue *v = find_var_interned(op->name);
+                if (v) {
+                    value_retain(*v);
+                    stack[sp++] = *v;
+                } else {
+                    stack[sp++] = value_int(0);
+                }
+                break;
+            }
+
+            case MOp_Neg: {
+                MValue *v = &stack[sp - 1];
+                if (v->type == MValueType_Int) { v->i = int_neg(v->i); break; }
+                double f = value_as_double(*v);
+                value_release(*v);
+                *v = value_float(-f);
+                break;
+            }
+
+            case MOp_Eq:
+            case MOp_Ne: {
+                MValue b = stack[--sp], a = stack[sp - 1];
+                int eq = value_equals(a, b);
+                value_release(a);
+                value_release(b);
+                stack[sp - 1] = value_bool(op->op == MOp_Ne ? !eq : eq);
+                break;
+            }
+
+            default: {
+                MValue b = stack[--sp], *a = &stack[sp - 1];
+                if (a->type == MValueType_Int && b.type == MValueType_Int) {
+                    switch (op->op) {
+                        case MOp_Add: a->i = int_add(a->i, b.i); break;
+                        case MOp_Sub: a->i = int_sub(a->i, b.i); break;
+                        case MOp_Mul: a->i = int_mul(a->i, b.i); break;
+                        default:      a->i = int_div(a->i, b.i); break;
+                    }
+                } else {
+                    *a = value_arith((char)op->op, *a, b);
+                }
+                break;
+            }
+        }
+    }
+    return sp ? stack[sp - 1] : value_int(0);
+}
+
+// Compiles and runs text once; used for declarations.
+static MValue eval_expr(const char *text) {
+    MExpr e;
+    if (compile_expr(text, &e)) return value_int(0);
+    MValue v = run_expr(&e);
+    free_expr(&e);
+    return v;
+}
+
+// Out-of-range coordinates clamp to the int range; NaN becomes 0.
+static int eval_coord(const MExpr *e) {
+    MValue v = run_expr(e);
+    if (v.type == MValueType_Int) return v.i > INT_MAX ? INT_MAX : v.i < INT_MIN ? INT_MIN : (int)v.i;
+    double d = value_as_double(v);
+    value_release(v);
+    if (isnan(d)) return 0;
+    if (d >= INT_MAX) return INT_MAX;
+    if (d <= INT_MIN) return INT_MIN;
+    return (int)lround(d);
+}
+
+#define _decl_iter(_F, ...)          \
+    _F(varint, Int, __VA_ARGS__)      \
+    _F(varfloat, Float, __VA_ARGS__)  \
+    _F(varbool, Bool, __VA_ARGS__)    \
+    _F(varstr, String, __VA_ARGS__)   \
+
+// Consumes v.
+static MValue coerce_value(MValue v, MValueType type) {
+    MValue out;
+    switch (type) {
+        case MValueType_Int:    out = value_int(value_as_int(v)); break;
+        case MValueType_Float:  out = value_float(value_as_double(v)); break;
+        case MValueType_Bool:   out = value_bool(value_truthy(v)); break;
+        case MValueType_String: return value_as_string(v);
+        default: return v;
+    }
+    value_release(v);
+    return out;
+}
+
+typedef struct {
+    char name[32];
+    char expr[128];
+    MValueType type;
+    int is_global;
+    size_t line;
+} MDecl;
+
+// Parses "[global] var<type> name = expr". Returns 0 if the line is not a
+// declaration, -1 if it is one but malformed.
+static int parse_declaration(const char *line, MDecl *decl) {
+    int is_global = 0;
+    if (strncmp(line, "global ", 7) == 0) {
+        is_global = 1;
+        line += 7;
+        while (*line && isspace((unsigned char)*line)) line++;
+    }
+
+    MValueType type = MValueType_Int;
+    size_t kw_len = 0;
+#define decl_match(kw, vt, ...) \
+    if (!kw_len && strncmp(line, #kw, sizeof(#kw) - 1) == 0 && isspace((unsigned char)line[sizeof(#kw) - 1])) { \
+        type = MValueType_##vt; kw_len = sizeof(#kw) - 1; }
+    _decl_iter(decl_match)
+#undef decl_match
+    if (!kw_len) return 0;
+
+    if (sscanf(line + kw_len, " %31[A-Za-z0-9_] = %127[^\n]", decl->name, decl->expr) != 2) return -1;
+    decl->type = type;
+    decl->is_global = is_global;
+    return 1;
 }
 
 
@@ -244,19 +569,78 @@ typedef struct {
         _cmd_iter(hunionmem)
     };
     MCommandType type;
+    size_t line;
+    MProfStat prof;
 } MCommand;
 
 typedef struct {
     char key[16];
+    CGKeyCode code;
+    int has_code;
     MCommand *commands;
     size_t cmd_count;
+    size_t line;
+    const char *file; // owned by MScript.files, NULL for a single parse
+    MProfStat prof;
 } MHotkey;
 
+typedef struct {
+    size_t line;
+    char msg[96];
+} MParseError;
+
 typedef struct {
     MHotkey *hotkeys;
     size_t hotkey_count;
+    MDecl *decls;
+    size_t decl_count;
+    MParseError *errors;
+    size_t error_count;
+    char **files;
+    size_t file_count;
 } MScript;
 
+static void add_parse_error(MScript *script, size_t line, const char *fmt, ...) {
+    MParseError *errors = (MParseError*)realloc(script->errors, (script->error_count + 1) * sizeof(MParseError));
+    if (!errors) return;
+    script->errors = errors;
+
+    MParseError *e = &errors[script->error_count++];
+    e->line = line;
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(e->msg, sizeof(e->msg), fmt, args);
+    va_end(args);
+}
+
+static void print_parse_errors(const MScript *script, const char *filename) {
+    for (size_t i = 0; i < script->error_count; i++)
+        fprintf(stderr, "%s:%zu: %s\n", filename, script->errors[i].line, script->errors[i].msg);
+}
+
+// Syntax check only; resolve_script() compiles the expressions for real.
+static const char *check_command(const MCommand *cmd) {
+    const char *err = NULL;
+    switch (cmd->type) {
+        case MCommandType_CursorMove:
+            if (!(err = compile_expr(cmd->CursorMove.expr_x, NULL)))
+                err = compile_expr(cmd->CursorMove.expr_y, NULL);
+            break;
+        case MCommandType_HMouseClick:
+            if (!(err = compile_expr(cmd->HMouseClick.expr_x, NULL)))
+                err = compile_expr(cmd->HMouseClick.expr_y, NULL);
+            break;
+        case MCommandType_SetVar:
+            err = compile_expr(cmd->SetVar.expr, NULL);
+            break;
+        default: break;
+    }
+    return err;
+}
+
+// Touches no global state, so several files can be parsed concurrently.
+// Declarations are only recorded; apply_declarations() defines them, and
+// resolve_script() compiles the command expressions.
 static MScript parse_script(const MFile *mf) {
     MScript script = {0};
     MHotkey *current_hotkey = NULL;
@@ -267,42 +651,57 @@ static MScript parse_script(const MFile *mf) {
 
         char *trim_line = line;
         while (*trim_line && isspace(*trim_line)) trim_line++;
-        if (strncmp(trim_line, "varint", 6) == 0 || strncmp(trim_line, "global varint", 13) == 0) {
-            char name[32];
-            int val;
-            int is_global = 0;
-
-            if (strncmp(trim_line, "global varint", 13) == 0) {
-                is_global = 1;
-                if (sscanf(trim_line + 13, " %31s = %d", name, &val) == 2) {
-                    if (is_global) set_global_var(name, val);
-                    else set_var(name, val); // redundant, but keeps API consistent
-                }
-            } else {
-                if (sscanf(trim_line + 6, " %31s = %d", name, &val) == 2) {
-                    set_var(name, val);
-                }
+
+        MDecl decl;
+        int is_decl = parse_declaration(trim_line, &decl);
+        if (is_decl < 0) {
+            add_parse_error(&script, i + 1, "malformed declaration");
+            continue;
+        }
+        if (is_decl) {
+            const char *err = compile_expr(decl.expr, NULL);
+            if (err) {
+                add_parse_error(&script, i + 1, "bad expression: %s", err);
+                continue;
             }
+            MDecl *decls = (MDecl*)realloc(script.decls, (script.decl_count + 1) * sizeof(MDecl));
+            if (!decls) continue;
+            script.decls = decls;
+            decl.line = i + 1;
+            script.decls[script.decl_count++] = decl;
             continue;
         }
 
-
         if (strncmp(trim_line, "hotkey", 6) == 0) {
             script.hotkeys = (MHotkey*)realloc(script.hotkeys, (script.hotkey_count + 1) * sizeof(MHotkey));
             current_hotkey = &script.hotkeys[script.hotkey_count];
             current_hotkey->commands = NULL;
             current_hotkey->cmd_count = 0;
+            current_hotkey->line = i + 1;
+            current_hotkey->file = NULL;
+            current_hotkey->key[0] = '\0';
+            current_hotkey->has_code = 0;
+            memset(&current_hotkey->prof, 0, sizeof(MProfStat));
             script.hotkey_count++;
 
             char *key_start = trim_line + 6;
             while (*key_start && isspace(*key_start)) key_start++;
             char *key_end = strstr(key_start, "->");
-            if (!key_end) continue;
+            if (!key_end) {
+                add_parse_error(&script, i + 1, "expected '<Key> ->'");
+                continue;
+            }
 
             size_t key_len = key_end - key_start;
             if (key_len >= sizeof(current_hotkey->key)) key_len = sizeof(current_hotkey->key)-1;
             strncpy(current_hotkey->key, key_start, key_len);
             current_hotkey->key[key_len] = '\0';
+            while (key_len > 0 && isspace((unsigned char)current_hotkey->key[key_len - 1]))
+                current_hotkey->key[--key_len] = '\0';
+
+            current_hotkey->has_code = lookup_keycode(current_hotkey->key, &current_hotkey->code);
+            if (!current_hotkey->has_code)
+                add_parse_error(&script, i + 1, "unknown hotkey '%s'", current_hotkey->key);
             continue;
         }
 
@@ -322,45 +721,59 @@ static MScript parse_script(const MFile *mf) {
 
                     cmd.CursorMove.duration = (n == 3) ? dur : 0.0f;
                     cmd.type = MCommandType_CursorMove;
-                } else continue;
+                } else { add_parse_error(&script, i + 1, "bad CursorMove"); continue; }
             }
 
             else if (strncmp(trim_line, "set ", 4) == 0) {
-                char name[32], expr[64];
-                if (sscanf(trim_line, "set %31s = %63[^\n]", name, expr) == 2) {
+                char name[32], expr[128];
+                if (sscanf(trim_line, "set %31s = %127[^\n]", name, expr) == 2) {
                     cmd.type = MCommandType_SetVar;
                     strcpy(cmd.SetVar.name, name);
                     strcpy(cmd.SetVar.expr, expr);
                 } 
                 else 
                 {
+                    add_parse_error(&script, i + 1, "bad set");
                     continue;
                 }
             }
             else if (strncmp(trim_line, "KeyPress,", 9) == 0) {
-                if (sscanf(trim_line, "KeyPress, %c", &cmd.KeyPress.key) == 1) cmd.type = MCommandType_KeyPress;
-                else continue;
+                char key[MKEY_MAX_NAME];
+                if (sscanf(trim_line, "KeyPress, %31s", key) == 1 && lookup_keycode(key, &cmd.KeyPress.key)) cmd.type = MCommandType_KeyPress;
+                else { add_parse_error(&script, i + 1, "bad KeyPress"); continue; }
             }
             else if (strncmp(trim_line, "MouseClick,", 11) == 0) {
                 char xs[32], ys[32];
-                float dur = 0.0f;
-                int n = sscanf(trim_line, "MouseClick, %31[^,], %31[^,], %f", xs, ys, &dur);
+                int button = 0;
+                int n = sscanf(trim_line, "MouseClick, %31[^,], %31[^,], %d", xs, ys, &button);
                 if (n >= 2) {
                     strncpy(cmd.HMouseClick.expr_x, xs, 31);
                     strncpy(cmd.HMouseClick.expr_y, ys, 31);
                     cmd.HMouseClick.expr_x[31] = 0;
                     cmd.HMouseClick.expr_y[31] = 0;
 
-                    cmd.HMouseClick.clickType = 0;
+                    cmd.HMouseClick.clickType = (n == 3 && button == 1) ? kCGMouseButtonRight : kCGMouseButtonLeft;
                     cmd.type = MCommandType_HMouseClick;
-                } else continue;
+                } else { add_parse_error(&script, i + 1, "bad MouseClick"); continue; }
             }
             else if (strncmp(trim_line, "KeyRelease,", 11) == 0) {
-                if (sscanf(trim_line, "KeyRelease, %c", &cmd.KeyRelease.key) == 1) cmd.type = MCommandType_KeyRelease;
-                else continue;
+                char key[MKEY_MAX_NAME];
+                if (sscanf(trim_line, "KeyRelease, %31s", key) == 1 && lookup_keycode(key, &cmd.KeyRelease.key)) cmd.type = MCommandType_KeyRelease;
+                else { add_parse_error(&script, i + 1, "bad KeyRelease"); continue; }
+            }
+            else {
+                if (isalpha((unsigned char)*trim_line))
+                    add_parse_error(&script, i + 1, "unknown command");
+                continue;
             }
-            else continue;
 
+            const char *err = check_command(&cmd);
+            if (err) {
+                add_parse_error(&script, i + 1, "bad expression: %s", err);
+                continue;
+            }
+
+            cmd.line = i + 1;
             current_hotkey->commands = (MCommand*)realloc(current_hotkey->commands, (current_hotkey->cmd_count + 1) * sizeof(MCommand));
             current_hotkey->commands[current_hotkey->cmd_count++] = cmd;
         }
@@ -369,12 +782,94 @@ static MScript parse_script(const MFile *mf) {
     return script;
 }
 
+// Returns the number of declarations that could not be stored (out of memory).
+static size_t apply_declarations(const MScript *script) {
+    size_t dropped = 0;
+    for (size_t i = 0; i < script->decl_count; i++) {
+        const MDecl *d = &script->decls[i];
+        MValue val = coerce_value(eval_expr(d->expr), d->type);
+        int stored = d->is_global ? set_global_var(d->name, val) : set_var(d->name, val);
+        if (!stored) dropped++;
+    }
+    return dropped;
+}
+
+// Returns NULL on success, or why an expression failed to compile.
+static const char *resolve_command(MCommand *cmd) {
+    const char *err = NULL;
+    switch (cmd->type) {
+        case MCommandType_CursorMove:
+            if (!(err = compile_expr(cmd->CursorMove.expr_x, &cmd->CursorMove.x)))
+                err = compile_expr(cmd->CursorMove.expr_y, &cmd->CursorMove.y);
+            break;
+        case MCommandType_HMouseClick:
+            if (!(err = compile_expr(cmd->HMouseClick.expr_x, &cmd->HMouseClick.x)))
+                err = compile_expr(cmd->HMouseClick.expr_y, &cmd->HMouseClick.y);
+            break;
+        case MCommandType_SetVar:
+            cmd->SetVar.iname = intern(cmd->SetVar.name);
+            if (!cmd->SetVar.iname) return "out of memory";
+            err = compile_expr(cmd->SetVar.expr, &cmd->SetVar.value);
+            break;
+        default: break;
+    }
+    return err;
+}
+
+// Compiles every command expression and interns variable names. Interns, so
+// it runs single-threaded after parsing. parse_script() has already checked
+// the syntax, so failures here are out of memory. Returns their number.
+static size_t resolve_script(MScript *script) {
+    size_t failed = 0;
+    for (size_t i = 0; i < script->hotkey_count; i++) {
+        MHotkey *hk = &script->hotkeys[i];
+        for (size_t j = 0; j < hk->cmd_count; j++) {
+            const char *err = resolve_command(&hk->commands[j]);
+            if (!err) continue;
+            fprintf(stderr, "%s:%zu: bad expression: %s\n",
+                    hk->file ? hk->file : "script", hk->commands[j].line, err);
+            failed++;
+        }
+    }
+    return failed;
+}
+
+static void free_command(MCommand *cmd) {
+    switch (cmd->type) {
+        case MCommandType_CursorMove:
+            free_expr(&cmd->CursorMove.x);
+            free_expr(&cmd->CursorMove.y);
+            break;
+        case MCommandType_HMouseClick:
+            free_expr(&cmd->HMouseClick.x);
+            free_expr(&cmd->HMouseClick.y);
+            break;
+        case MCommandType_SetVar:
+            free_expr(&cmd->SetVar.value);
+            break;
+        default: break;
+    }
+}
+
 static void free_script(MScript *script) {
-    for (size_t i = 0; i < script->hotkey_count; i++)
+    for (size_t i = 0; i < script->hotkey_count; i++) {
+        for (size_t j = 0; j < script->hotkeys[i].cmd_count; j++)
+            free_command(&script->hotkeys[i].commands[j]);
         free(script->hotkeys[i].commands);
+    }
     free(script->hotkeys);
+    free(script->decls);
+    free(script->errors);
+    for (size_t i = 0; i < script->file_count; i++) free(script->files[i]);
+    free(script->files);
     script->hotkeys = NULL;
     script->hotkey_count = 0;
+    script->decls = NULL;
+    script->decl_count = 0;
+    script->errors = NULL;
+    script->error_count = 0;
+    script->files = NULL;
+    script->file_count = 0;
 }
 static void print_script(const MScript *script) {
     for (size_t i = 0; i < script->hotkey_count; i++) {
@@ -390,18 +885,18 @@ static void print_script(const MScript *script) {
                     break;
 
                 case MCommandType_KeyPress:
-                    printf("  KeyPress: %c\n", cmd.KeyPress.key);
+                    printf("  KeyPress: %s\n", keycode_name(cmd.KeyPress.key));
                     break;
 
                 case MCommandType_KeyRelease:
-                    printf("  KeyRelease: %c\n", cmd.KeyRelease.key);
+                    printf("  KeyRelease: %s\n", keycode_name(cmd.KeyRelease.key));
                     break;
 
                 case MCommandType_HMouseClick:
-                    printf("  MouseClick: %s, %s, %.2f\n",
+                    printf("  MouseClick: %s, %s, %u\n",
                            cmd.HMouseClick.expr_x,
                            cmd.HMouseClick.expr_y,
-                           cmd.HMouseClick.clickType);
+                           (unsigned)cmd.HMouseClick.clickType);
                     break;
 
                 case MCommandType_SetVar:
@@ -416,55 +911,202 @@ static void print_script(const MScript *script) {
     }
 }
 
+#define htypes_name(name, val, ...) case MCommandType_##name: return #name;
+
+static const char *command_type_name(MCommandType type) {
+    switch (type) {
+        _cmd_iter(htypes_name)
+    }
+    return "Unknown";
+}
+
+typedef struct {
+    char label[96];
+    const MProfStat *stat;
+    uint64_t total_ns;
+} MProfRow;
+
+static int compare_prof_rows(const void *a, const void *b) {
+    uint64_t x = ((const MProfRow*)a)->total_ns, y = ((const MProfRow*)b)->total_ns;
+    return (x < y) - (x > y);
+}
+
+// "F8 (path/to/file.msr:12)"; allocated because paths have no useful bound.
+static char *hotkey_label(const MHotkey *hk) {
+    int n = hk->file ? snprintf(NULL, 0, "%s (%s:%zu)", hk->key, hk->file, hk->line)
+                     : snprintf(NULL, 0, "%s (line %zu)", hk->key, hk->line);
+    char *label = (char*)malloc(n + 1);
+    if (!label) return NULL;
+    if (hk->file) snprintf(label, n + 1, "%s (%s:%zu)", hk->key, hk->file, hk->line);
+    else snprintf(label, n + 1, "%s (line %zu)", hk->key, hk->line);
+    return label;
+}
+
+// ';' separates frames in folded stacks, so a hotkey on ';' (or a path
+// containing one) is written with the key's alias instead.
+static void write_frame(FILE *f, const char *label) {
+    for (; *label; label++) {
+        if (*label == ';') fputs("Semicolon", f);
+        else fputc(*label, f);
+    }
+}
+
+// Writes folded stacks (flamegraph.pl input, values in ns) to path and,
+// with summary set, a top-N table to stderr. The file is written beside path
+// and renamed over it, so a reader never sees a partial profile.
+static void write_profile(const MScript *script, const char *path, int summary) {
+    size_t row_count = 0;
+    MProfRow *rows = NULL;
+    if (summary) {
+        size_t row_cap = MPROF_MAX_EVENTS;
+        for (size_t i = 0; i < script->hotkey_count; i++) row_cap += 1 + script->hotkeys[i].cmd_count;
+        rows = (MProfRow*)calloc(row_cap, sizeof(MProfRow));
+    }
+
+    char tmp_path[1024];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+    FILE *f = fopen(tmp_path, "w");
+    if (!f) perror("Failed to open profile output");
+
+    for (size_t i = 0; i < script->hotkey_count; i++) {
+        const MHotkey *hk = &script->hotkeys[i];
+        uint64_t hk_ns = prof_estimate_ns(&hk->prof), child_ns = 0;
+        char *hk_label = hotkey_label(hk);
+        if (!hk_label) continue;
+
+        for (size_t j = 0; j < hk->cmd_count; j++) {
+            const MCommand *cmd = &hk->commands[j];
+            uint64_t ns = prof_estimate_ns(&cmd->prof);
+            child_ns += ns;
+            if (f && ns) {
+                write_frame(f, hk_label);
+                fprintf(f, ";%s (line %zu) %llu\n", command_type_name(cmd->type), cmd->line, (unsigned long long)ns);
+            }
+            if (rows && cmd->prof.count) {
+                MProfRow *r = &rows[row_count++];
+                snprintf(r->label, sizeof(r->label), "%s (line %zu) in %s",
+                         command_type_name(cmd->type), cmd->line, hk->key);
+                r->stat = &cmd->prof;
+                r->total_ns = ns;
+            }
+        }
+
+        if (f && hk_ns > child_ns) {
+            write_frame(f, hk_label);
+            fprintf(f, " %llu\n", (unsigned long long)(hk_ns - child_ns));
+        }
+        if (rows && hk->prof.count) {
+            MProfRow *r = &rows[row_count++];
+            const char *base = hk->file ? strrchr(hk->file, '/') : NULL;
+            if (hk->file) snprintf(r->label, sizeof(r->label), "hotkey %s (%s:%zu)", hk->key, base ? base + 1 : hk->file, hk->line);
+            else snprintf(r->label, sizeof(r->label), "hotkey %s (line %zu)", hk->key, hk->line);
+            r->stat = &hk->prof;
+            r->total_ns = hk_ns;
+        }
+        free(hk_label);
+    }
+
+    for (int i = 0; i < MPROF_MAX_EVENTS; i++) {
+        const MProfStat *stat = &MProfiler.events[i];
+        if (!stat->count) continue;
+        const char *name = node_type_name((MEventType)(i + MEvent_Empty));
+        uint64_t ns = prof_estimate_ns(stat);
+        if (f && ns) fprintf(f, "post;%s %llu\n", name, (unsigned long long)ns);
+        if (rows) {
+            MProfRow *r = &rows[row_count++];
+            snprintf(r->label, sizeof(r->label), "post %s", name);
+            r->stat = stat;
+            r->total_ns = ns;
+        }
+    }
+    if (f) {
+        if (fclose(f) != 0 || rename(tmp_path, path) != 0) perror("Failed to write profile output");
+    }
+
+    if (!rows) return;
+    qsort(rows, row_count, sizeof(MProfRow), compare_prof_rows);
+    fprintf(stderr, "=== PROFILE (1 in %u timed, folded stacks in %s) ===\n", MProfiler.sample_every, path);
+    fprintf(stderr, "  %12s %12s %10s  %s\n", "count", "total ms", "avg us", "where");
+    for (size_t i = 0; i < row_count && i < MPROF_TOP_N; i++) {
+        const MProfRow *r = &rows[i];
+        fprintf(stderr, "  %12llu %12.3f %10.3f  %s\n",
+                (unsigned long long)r->stat->count, r->total_ns / 1e6,
+                r->stat->count ? r->total_ns / 1e3 / r->stat->count : 0.0, r->label);
+    }
+    fprintf(stderr, "==================\n");
+    free(rows);
+}
 
 static void execute_command(MCommand *cmd) {
     switch (cmd->type) {
         case MCommandType_SetVar: {
-            int v = eval_expr(cmd->SetVar.expr);
-            set_var(cmd->SetVar.name, v);
+            MValue v = run_expr(&cmd->SetVar.value);
+            set_var_interned(cmd->SetVar.iname, v);
             break;
         }
 
         case MCommandType_CursorMove: {
-            int x = eval_expr(cmd->CursorMove.expr_x); 
-            int y = eval_expr(cmd->CursorMove.expr_y);
+            int x = eval_coord(&cmd->CursorMove.x); 
+            int y = eval_coord(&cmd->CursorMove.y);
             push_node(create_node(MEvent_MouseMove, x, y, cmd->CursorMove.duration));
             break;
         }
 
         case MCommandType_HMouseClick: {
-            int x = eval_expr(cmd->HMouseClick.expr_x); 
-            int y = eval_expr(cmd->HMouseClick.expr_y);
+            int x = eval_coord(&cmd->HMouseClick.x); 
+            int y = eval_coord(&cmd->HMouseClick.y);
             //printf("%d, %d\n", x, y);
             push_node(create_node(MEvent_MouseClick, x, y, cmd->HMouseClick.clickType));
             break;
         }
 
+        case MCommandType_KeyPress: {
+            push_node(create_node(MEvent_KeyDown, cmd->KeyPress.key));
+            break;
+        }
+
+        case MCommandType_KeyRelease: {
+            push_node(create_node(MEvent_KeyUp, cmd->KeyRelease.key));
+            break;
+        }
+
         default: break;
     }
 }
-static CGEventRef hotkey_callback(CGEventTapProxy proxy, CGEventType type, CGEventRef event, void *userInfo) {
-    if (type != kCGEventKeyDown) return event;
-
-     CGKeyCode code = (CGKeyCode)CGEventGetIntegerValueField(event, kCGKeyboardEventKeycode);
-    //printf("Key pressed code: %u\n", code); 
-    MScript *script = (MScript*)userInfo;
-    //print_script(script);
+static void dispatch_key(MScript *script, CGKeyCode code) {
     for (size_t i = 0; i < script->hotkey_count; i++) {
         MHotkey *hk = &script->hotkeys[i];
-        CGKeyCode hk_code = get_keycode(hk->key);
-        //printf("key: %s, retrieved: %u, %u bool: %d\n", hk->key, code, get_keycode(hk->key), hk_code == code);
-        if (hk_code == code) {
+        //printf("key: %s, retrieved: %u, %u\n", hk->key, code, hk->code);
+        if (hk->has_code && hk->code == code) {
+            uint64_t hk_start = prof_begin(&hk->prof);
             push_frame();
             for (size_t j = 0; j < hk->cmd_count; j++) {
-                execute_command(&hk->commands[j]);
+                MCommand *cmd = &hk->commands[j];
+                uint64_t start = prof_begin(&cmd->prof);
+                execute_command(cmd);
+                prof_end(&cmd->prof, start);
             }
             pop_frame();
+            prof_end(&hk->prof, hk_start);
         }
 
     }
+}
+
+#ifdef __APPLE__
+static CGEventRef hotkey_callback(CGEventTapProxy proxy, CGEventType type, CGEventRef event, void *userInfo) {
+    if (type != kCGEventKeyDown) return event;
+    // Our own KeyPress/KeyRelease output must not trigger hotkeys again.
+    if (CGEventGetIntegerValueField(event, kCGEventSourceUserData) == M_EVENT_TAG) return event;
+
+     CGKeyCode code = (CGKeyCode)CGEventGetIntegerValueField(event, kCGKeyboardEventKeycode);
+    //printf("Key pressed code: %u\n", code); 
+    MScript *script = (MScript*)userInfo;
+    //print_script(script);
+    dispatch_key(script, code);
 
     return event;
 }
+#endif
 
 #endif
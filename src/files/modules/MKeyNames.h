@@ -0,0 +1,221 @@
+#ifndef MKEYNAMES_H
+#define MKEYNAMES_H
+#include <stddef.h>
+#include <stdint.h>
+
+// Source of truth for key names. MKeyTable.h is generated from these lists
+// by tools/gen_keytable.c; regenerate it after editing them.
+// Names are matched case-insensitively. The first list holds the canonical
+// name for each virtual keycode (used for reverse lookup), the second extra
+// spellings.
+
+#define _key_iter(_F, ...)                  \
+    _F("A", 0, __VA_ARGS__)                 \
+    _F("S", 1, __VA_ARGS__)                 \
+    _F("D", 2, __VA_ARGS__)                 \
+    _F("F", 3, __VA_ARGS__)                 \
+    _F("H", 4, __VA_ARGS__)                 \
+    _F("G", 5, __VA_ARGS__)                 \
+    _F("Z", 6, __VA_ARGS__)                 \
+    _F("X", 7, __VA_ARGS__)                 \
+    _F("C", 8, __VA_ARGS__)                 \
+    _F("V", 9, __VA_ARGS__)                 \
+    _F("Section", 10, __VA_ARGS__)          \
+    _F("B", 11, __VA_ARGS__)                \
+    _F("Q", 12, __VA_ARGS__)                \
+    _F("W", 13, __VA_ARGS__)                \
+    _F("E", 14, __VA_ARGS__)                \
+    _F("R", 15, __VA_ARGS__)                \
+    _F("Y", 16, __VA_ARGS__)                \
+    _F("T", 17, __VA_ARGS__)                \
+    _F("1", 18, __VA_ARGS__)                \
+    _F("2", 19, __VA_ARGS__)                \
+    _F("3", 20, __VA_ARGS__)                \
+    _F("4", 21, __VA_ARGS__)                \
+    _F("6", 22, __VA_ARGS__)                \
+    _F("5", 23, __VA_ARGS__)                \
+    _F("=", 24, __VA_ARGS__)                \
+    _F("9", 25, __VA_ARGS__)                \
+    _F("7", 26, __VA_ARGS__)                \
+    _F("-", 27, __VA_ARGS__)                \
+    _F("8", 28, __VA_ARGS__)                \
+    _F("0", 29, __VA_ARGS__)                \
+    _F("RightBracket", 30, __VA_ARGS__)     \
+    _F("O", 31, __VA_ARGS__)                \
+    _F("U", 32, __VA_ARGS__)                \
+    _F("LeftBracket", 33, __VA_ARGS__)      \
+    _F("I", 34, __VA_ARGS__)                \
+    _F("P", 35, __VA_ARGS__)                \
+    _F("Return", 36, __VA_ARGS__)           \
+    _F("L", 37, __VA_ARGS__)                \
+    _F("J", 38, __VA_ARGS__)                \
+    _F("'", 39, __VA_ARGS__)                \
+    _F("K", 40, __VA_ARGS__)                \
+    _F(";", 41, __VA_ARGS__)                \
+    _F("\\", 42, __VA_ARGS__)               \
+    _F(",", 43, __VA_ARGS__)                \
+    _F("/", 44, __VA_ARGS__)                \
+    _F("N", 45, __VA_ARGS__)                \
+    _F("M", 46, __VA_ARGS__)                \
+    _F(".", 47, __VA_ARGS__)                \
+    _F("Tab", 48, __VA_ARGS__)              \
+    _F("Space", 49, __VA_ARGS__)            \
+    _F("Backtick", 50, __VA_ARGS__)         \
+    _F("Delete", 51, __VA_ARGS__)           \
+    _F("Escape", 53, __VA_ARGS__)           \
+    _F("RightCommand", 54, __VA_ARGS__)     \
+    _F("Command", 55, __VA_ARGS__)          \
+    _F("Shift", 56, __VA_ARGS__)            \
+    _F("CapsLock", 57, __VA_ARGS__)         \
+    _F("Option", 58, __VA_ARGS__)           \
+    _F("Control", 59, __VA_ARGS__)          \
+    _F("RightShift", 60, __VA_ARGS__)       \
+    _F("RightOption", 61, __VA_ARGS__)      \
+    _F("RightControl", 62, __VA_ARGS__)     \
+    _F("Function", 63, __VA_ARGS__)         \
+    _F("F17", 64, __VA_ARGS__)              \
+    _F("KeypadDecimal", 65, __VA_ARGS__)    \
+    _F("KeypadMultiply", 67, __VA_ARGS__)   \
+    _F("KeypadPlus", 69, __VA_ARGS__)       \
+    _F("KeypadClear", 71, __VA_ARGS__)      \
+    _F("VolumeUp", 72, __VA_ARGS__)         \
+    _F("VolumeDown", 73, __VA_ARGS__)       \
+    _F("Mute", 74, __VA_ARGS__)             \
+    _F("KeypadDivide", 75, __VA_ARGS__)     \
+    _F("KeypadEnter", 76, __VA_ARGS__)      \
+    _F("KeypadMinus", 78, __VA_ARGS__)      \
+    _F("F18", 79, __VA_ARGS__)              \
+    _F("F19", 80, __VA_ARGS__)              \
+    _F("KeypadEquals", 81, __VA_ARGS__)     \
+    _F("Keypad0", 82, __VA_ARGS__)          \
+    _F("Keypad1", 83, __VA_ARGS__)          \
+    _F("Keypad2", 84, __VA_ARGS__)          \
+    _F("Keypad3", 85, __VA_ARGS__)          \
+    _F("Keypad4", 86, __VA_ARGS__)          \
+    _F("Keypad5", 87, __VA_ARGS__)          \
+    _F("Keypad6", 88, __VA_ARGS__)          \
+    _F("Keypad7", 89, __VA_ARGS__)          \
+    _F("F20", 90, __VA_ARGS__)              \
+    _F("Keypad8", 91, __VA_ARGS__)          \
+    _F("Keypad9", 92, __VA_ARGS__)          \
+    _F("Yen", 93, __VA_ARGS__)              \
+    _F("Underscore", 94, __VA_ARGS__)       \
+    _F("KeypadComma", 95, __VA_ARGS__)      \
+    _F("F5", 96, __VA_ARGS__)               \
+    _F("F6", 97, __VA_ARGS__)               \
+    _F("F7", 98, __VA_ARGS__)               \
+    _F("F3", 99, __VA_ARGS__)               \
+    _F("F8", 100, __VA_ARGS__)              \
+    _F("F9", 101, __VA_ARGS__)              \
+    _F("Eisu", 102, __VA_ARGS__)            \
+    _F("F11", 103, __VA_ARGS__)             \
+    _F("Kana", 104, __VA_ARGS__)            \
+    _F("F13", 105, __VA_ARGS__)             \
+    _F("F16", 106, __VA_ARGS__)             \
+    _F("F14", 107, __VA_ARGS__)             \
+    _F("F10", 109, __VA_ARGS__)             \
+    _F("F12", 111, __VA_ARGS__)             \
+    _F("F15", 113, __VA_ARGS__)             \
+    _F("Help", 114, __VA_ARGS__)            \
+    _F("Home", 115, __VA_ARGS__)            \
+    _F("PageUp", 116, __VA_ARGS__)          \
+    _F("ForwardDelete", 117, __VA_ARGS__)   \
+    _F("F4", 118, __VA_ARGS__)              \
+    _F("End", 119, __VA_ARGS__)             \
+    _F("F2", 120, __VA_ARGS__)              \
+    _F("PageDown", 121, __VA_ARGS__)        \
+    _F("F1", 122, __VA_ARGS__)              \
+    _F("LeftArrow", 123, __VA_ARGS__)       \
+    _F("RightArrow", 124, __VA_ARGS__)      \
+    _F("DownArrow", 125, __VA_ARGS__)       \
+    _F("UpArrow", 126, __VA_ARGS__)         \
+
+#define _key_alias_iter(_F, ...)            \
+    _F("Equal", 24, __VA_ARGS__)            \
+    _F("Minus", 27, __VA_ARGS__)            \
+    _F("]", 30, __VA_ARGS__)                \
+    _F("[", 33, __VA_ARGS__)                \
+    _F("Enter", 36, __VA_ARGS__)            \
+    _F("Quote", 39, __VA_ARGS__)            \
+    _F("Semicolon", 41, __VA_ARGS__)        \
+    _F("Backslash", 42, __VA_ARGS__)        \
+    _F("Comma", 43, __VA_ARGS__)            \
+    _F("Slash", 44, __VA_ARGS__)            \
+    _F("Period", 47, __VA_ARGS__)           \
+    _F("`", 50, __VA_ARGS__)                \
+    _F("Grave", 50, __VA_ARGS__)            \
+    _F("Backspace", 51, __VA_ARGS__)        \
+    _F("Esc", 53, __VA_ARGS__)              \
+    _F("RightCmd", 54, __VA_ARGS__)         \
+    _F("Cmd", 55, __VA_ARGS__)              \
+    _F("LeftCommand", 55, __VA_ARGS__)      \
+    _F("LeftCmd", 55, __VA_ARGS__)          \
+    _F("LeftShift", 56, __VA_ARGS__)        \
+    _F("Caps", 57, __VA_ARGS__)             \
+    _F("Opt", 58, __VA_ARGS__)              \
+    _F("Alt", 58, __VA_ARGS__)              \
+    _F("LeftOption", 58, __VA_ARGS__)       \
+    _F("LeftAlt", 58, __VA_ARGS__)          \
+    _F("Ctrl", 59, __VA_ARGS__)             \
+    _F("LeftControl", 59, __VA_ARGS__)      \
+    _F("LeftCtrl", 59, __VA_ARGS__)         \
+    _F("RightOpt", 61, __VA_ARGS__)         \
+    _F("RightAlt", 61, __VA_ARGS__)         \
+    _F("RightCtrl", 62, __VA_ARGS__)        \
+    _F("Fn", 63, __VA_ARGS__)               \
+    _F("KeypadPeriod", 65, __VA_ARGS__)     \
+    _F("KeypadStar", 67, __VA_ARGS__)       \
+    _F("NumLock", 71, __VA_ARGS__)          \
+    _F("VolumeMute", 74, __VA_ARGS__)       \
+    _F("KeypadSlash", 75, __VA_ARGS__)      \
+    _F("Numpad0", 82, __VA_ARGS__)          \
+    _F("Numpad1", 83, __VA_ARGS__)          \
+    _F("Numpad2", 84, __VA_ARGS__)          \
+    _F("Numpad3", 85, __VA_ARGS__)          \
+    _F("Numpad4", 86, __VA_ARGS__)          \
+    _F("Numpad5", 87, __VA_ARGS__)          \
+    _F("Numpad6", 88, __VA_ARGS__)          \
+    _F("Numpad7", 89, __VA_ARGS__)          \
+    _F("Numpad8", 91, __VA_ARGS__)          \
+    _F("Numpad9", 92, __VA_ARGS__)          \
+    _F("Insert", 114, __VA_ARGS__)          \
+    _F("PgUp", 116, __VA_ARGS__)            \
+    _F("Del", 117, __VA_ARGS__)             \
+    _F("PgDn", 121, __VA_ARGS__)            \
+    _F("Left", 123, __VA_ARGS__)            \
+    _F("Right", 124, __VA_ARGS__)           \
+    _F("Down", 125, __VA_ARGS__)            \
+    _F("Up", 126, __VA_ARGS__)              \
+
+#define MKEY_MAX_CODE 128
+#define MKEY_MAX_NAME 32
+
+typedef struct {
+    const char *name;
+    uint16_t code;
+} MKeySlot;
+
+// FNV-1a over the lowercased name; the generator and lookup must agree.
+static inline uint32_t key_name_hash(const char *name) {
+    uint32_t h = 2166136261u;
+    for (; *name; name++) {
+        unsigned char c = (unsigned char)*name;
+        if (c >= 'A' && c <= 'Z') c += 'a' - 'A';
+        h ^= c;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// Second-level hash: remixes the name hash with the bucket's displacement.
+static inline uint32_t key_slot_hash(uint32_t h, uint32_t displacement) {
+    h ^= displacement * 0x9e3779b9u;
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+    return h;
+}
+
+#endif
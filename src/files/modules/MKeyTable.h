@@ -0,0 +1,410 @@
+// Generated by tools/gen_keytable.c from MKeyNames.h. Do not edit.
+#ifndef MKEYTABLE_H
+#define MKEYTABLE_H
+#include "MKeyNames.h"
+
+#define MKEY_HASH_BUCKETS 88
+#define MKEY_HASH_SLOTS 256
+
+static const uint16_t key_hash_displacement[MKEY_HASH_BUCKETS] = {
+    1, 1, 0, 5, 1, 2, 5, 3, 1, 2, 1, 4,
+    2, 1, 9, 4, 3, 1, 0, 0, 3, 10, 1, 0,
+    2, 3, 3, 5, 1, 3, 1, 2, 2, 2, 1, 5,
+    2, 17, 1, 1, 0, 3, 2, 2, 1, 2, 1, 1,
+    0, 5, 3, 2, 1, 7, 1, 2, 0, 0, 3, 6,
+    0, 3, 2, 2, 1, 2, 1, 5, 4, 4, 3, 9,
+    1, 4, 1, 1, 1, 7, 0, 2, 1, 0, 1, 3,
+    2, 2, 1, 3,
+};
+
+static const MKeySlot key_hash_slots[MKEY_HASH_SLOTS] = {
+    { NULL, 0 },
+    { "F13", 105 },
+    { "F3", 99 },
+    { NULL, 0 },
+    { "LeftAlt", 58 },
+    { NULL, 0 },
+    { "VolumeUp", 72 },
+    { "Escape", 53 },
+    { "KeypadDecimal", 65 },
+    { "E", 14 },
+    { NULL, 0 },
+    { "M", 46 },
+    { "LeftShift", 56 },
+    { NULL, 0 },
+    { "Control", 59 },
+    { "PgUp", 116 },
+    { "F5", 96 },
+    { "]", 30 },
+    { NULL, 0 },
+    { "RightCtrl", 62 },
+    { "=", 24 },
+    { NULL, 0 },
+    { NULL, 0 },
+    { "Z", 6 },
+    { "C", 8 },
+    { NULL, 0 },
+    { NULL, 0 },
+    { "Numpad6", 88 },
+    { "S", 1 },
+    { "LeftArrow", 123 },
+    { NULL, 0 },
+    { "Up", 126 },
+    { "/", 44 },
+    { NULL, 0 },
+    { NULL, 0 },
+    { "F", 3 },
+    { NULL, 0 },
+    { "LeftCmd", 55 },
+    { NULL, 0 },
+    { NULL, 0 },
+    { "F16", 106 },
+    { "LeftBracket", 33 },
+    { NULL, 0 },
+    { "B", 11 },
+    { "Left", 123 },
+    { NULL, 0 },
+    { "Shift", 56 },
+    { "F15", 113 },
+    { NULL, 0 },
+    { "F6", 97 },
+    { NULL, 0 },
+    { NULL, 0 },
+    { "Ctrl", 59 },
+    { NULL, 0 },
+    { "Keypad5", 87 },
+    { "Quote", 39 },
+    { "Eisu", 102 },
+    { "Keypad8", 91 },
+    { "Return", 36 },
+    { "Right", 124 },
+    { "Delete", 51 },
+    { NULL, 0 },
+    { NULL, 0 },
+    { NULL, 0 },
+    { "Insert", 114 },
+    { "KeypadEquals", 81 },
+    { NULL, 0 },
+    { "RightCmd", 54 },
+    { "U", 32 },
+    { "F19", 80 },
+    { "Numpad3", 85 },
+    { "RightOption", 61 },
+    { NULL, 0 },
+    { NULL, 0 },
+    { "Command", 55 },
+    { "2", 19 },
+    { "RightOpt", 61 },
+    { "Numpad5", 87 },
+    { NULL, 0 },
+    { NULL, 0 },
+    { "Numpad4", 86 },
+    { "W", 13 },
+    { "F18", 79 },
+    { "Minus", 27 },
+    { "RightCommand", 54 },
+    { "PageUp", 116 },
+    { "F1", 122 },
+    { NULL, 0 },
+    { "T", 17 },
+    { "3", 20 },
+    { "P", 35 },
+    { "6", 22 },
+    { NULL, 0 },
+    { NULL, 0 },
+    { "G", 5 },
+    { NULL, 0 },
+    { "4", 21 },
+    { NULL, 0 },
+    { "8", 28 },
+    { NULL, 0 },
+    { "Semicolon", 41 },
+    { "Keypad4", 86 },
+    { "F8", 100 },
+    { "RightAlt", 61 },
+    { "KeypadClear", 71 },
+    { "VolumeMute", 74 },
+    { NULL, 0 },
+    { "Numpad0", 82 },
+    { "KeypadMultiply", 67 },
+    { NULL, 0 },
+    { "-", 27 },
+    { NULL, 0 },
+    { "Numpad9", 92 },
+    { ";", 41 },
+    { NULL, 0 },
+    { "LeftControl", 59 },
+    { NULL, 0 },
+    { ",", 43 },
+    { "F17", 64 },
+    { "Q", 12 },
+    { "`", 50 },
+    { NULL, 0 },
+    { NULL, 0 },
+    { "F14", 107 },
+    { NULL, 0 },
+    { NULL, 0 },
+    { NULL, 0 },
+    { "Enter", 36 },
+    { "UpArrow", 126 },
+    { "X", 7 },
+    { "Backspace", 51 },
+    { "Tab", 48 },
+    { "Grave", 50 },
+    { "Numpad1", 83 },
+    { "RightArrow", 124 },
+    { "Keypad7", 89 },
+    { NULL, 0 },
+    { "Keypad1", 83 },
+    { NULL, 0 },
+    { "F4", 118 },
+    { "KeypadMinus", 78 },
+    { NULL, 0 },
+    { "9", 25 },
+    { "Comma", 43 },
+    { "Underscore", 94 },
+    { "KeypadStar", 67 },
+    { "Fn", 63 },
+    { "7", 26 },
+    { NULL, 0 },
+    { NULL, 0 },
+    { "LeftOption", 58 },
+    { "RightControl", 62 },
+    { NULL, 0 },
+    { "Home", 115 },
+    { NULL, 0 },
+    { "Help", 114 },
+    { "Del", 117 },
+    { "KeypadEnter", 76 },
+    { NULL, 0 },
+    { "NumLock", 71 },
+    { "Caps", 57 },
+    { "Mute", 74 },
+    { "RightBracket", 30 },
+    { NULL, 0 },
+    { "Period", 47 },
+    { "Function", 63 },
+    { "Keypad2", 84 },
+    { "LeftCommand", 55 },
+    { "F11", 103 },
+    { "0", 29 },
+    { ".", 47 },
+    { "J", 38 },
+    { "A", 0 },
+    { "5", 23 },
+    { "Kana", 104 },
+    { "KeypadSlash", 75 },
+    { "Slash", 44 },
+    { NULL, 0 },
+    { "F7", 98 },
+    { NULL, 0 },
+    { "KeypadComma", 95 },
+    { "Keypad3", 85 },
+    { "Numpad8", 91 },
+    { "F9", 101 },
+    { "'", 39 },
+    { "N", 45 },
+    { "CapsLock", 57 },
+    { NULL, 0 },
+    { "Space", 49 },
+    { "Option", 58 },
+    { NULL, 0 },
+    { NULL, 0 },
+    { "Opt", 58 },
+    { NULL, 0 },
+    { "F12", 111 },
+    { "PgDn", 121 },
+    { NULL, 0 },
+    { "Keypad6", 88 },
+    { "KeypadPlus", 69 },
+    { NULL, 0 },
+    { "End", 119 },
+    { "DownArrow", 125 },
+    { NULL, 0 },
+    { "LeftCtrl", 59 },
+    { NULL, 0 },
+    { "Section", 10 },
+    { "D", 2 },
+    { "Backslash", 42 },
+    { "[", 33 },
+    { NULL, 0 },
+    { "K", 40 },
+    { NULL, 0 },
+    { NULL, 0 },
+    { "Alt", 58 },
+    { "Keypad0", 82 },
+    { "PageDown", 121 },
+    { NULL, 0 },
+    { "Cmd", 55 },
+    { "H", 4 },
+    { "I", 34 },
+    { "Backtick", 50 },
+    { "L", 37 },
+    { NULL, 0 },
+    { "R", 15 },
+    { "V", 9 },
+    { "KeypadPeriod", 65 },
+    { "Y", 16 },
+    { NULL, 0 },
+    { NULL, 0 },
+    { NULL, 0 },
+    { "RightShift", 60 },
+    { "F2", 120 },
+    { NULL, 0 },
+    { NULL, 0 },
+    { "KeypadDivide", 75 },
+    { "\\", 42 },
+    { "Keypad9", 92 },
+    { NULL, 0 },
+    { NULL, 0 },
+    { "Numpad7", 89 },
+    { "Numpad2", 84 },
+    { "O", 31 },
+    { "Down", 125 },
+    { "ForwardDelete", 117 },
+    { "1", 18 },
+    { "Yen", 93 },
+    { NULL, 0 },
+    { "VolumeDown", 73 },
+    { NULL, 0 },
+    { NULL, 0 },
+    { "F10", 109 },
+    { "F20", 90 },
+    { "Esc", 53 },
+    { NULL, 0 },
+    { "Equal", 24 },
+    { NULL, 0 },
+};
+
+static const char *const key_code_names[MKEY_MAX_CODE] = {
+    /*   0 */ "A",
+    /*   1 */ "S",
+    /*   2 */ "D",
+    /*   3 */ "F",
+    /*   4 */ "H",
+    /*   5 */ "G",
+    /*   6 */ "Z",
+    /*   7 */ "X",
+    /*   8 */ "C",
+    /*   9 */ "V",
+    /*  10 */ "Section",
+    /*  11 */ "B",
+    /*  12 */ "Q",
+    /*  13 */ "W",
+    /*  14 */ "E",
+    /*  15 */ "R",
+    /*  16 */ "Y",
+    /*  17 */ "T",
+    /*  18 */ "1",
+    /*  19 */ "2",
+    /*  20 */ "3",
+    /*  21 */ "4",
+    /*  22 */ "6",
+    /*  23 */ "5",
+    /*  24 */ "=",
+    /*  25 */ "9",
+    /*  26 */ "7",
+    /*  27 */ "-",
+    /*  28 */ "8",
+    /*  29 */ "0",
+    /*  30 */ "RightBracket",
+    /*  31 */ "O",
+    /*  32 */ "U",
+    /*  33 */ "LeftBracket",
+    /*  34 */ "I",
+    /*  35 */ "P",
+    /*  36 */ "Return",
+    /*  37 */ "L",
+    /*  38 */ "J",
+    /*  39 */ "'",
+    /*  40 */ "K",
+    /*  41 */ ";",
+    /*  42 */ "\\",
+    /*  43 */ ",",
+    /*  44 */ "/",
+    /*  45 */ "N",
+    /*  46 */ "M",
+    /*  47 */ ".",
+    /*  48 */ "Tab",
+    /*  49 */ "Space",
+    /*  50 */ "Backtick",
+    /*  51 */ "Delete",
+    /*  52 */ NULL,
+    /*  53 */ "Escape",
+    /*  54 */ "RightCommand",
+    /*  55 */ "Command",
+    /*  56 */ "Shift",
+    /*  57 */ "CapsLock",
+    /*  58 */ "Option",
+    /*  59 */ "Control",
+    /*  60 */ "RightShift",
+    /*  61 */ "RightOption",
+    /*  62 */ "RightControl",
+    /*  63 */ "Function",
+    /*  64 */ "F17",
+    /*  65 */ "KeypadDecimal",
+    /*  66 */ NULL,
+    /*  67 */ "KeypadMultiply",
+    /*  68 */ NULL,
+    /*  69 */ "KeypadPlus",
+    /*  70 */ NULL,
+    /*  71 */ "KeypadClear",
+    /*  72 */ "VolumeUp",
+    /*  73 */ "VolumeDown",
+    /*  74 */ "Mute",
+    /*  75 */ "KeypadDivide",
+    /*  76 */ "KeypadEnter",
+    /*  77 */ NULL,
+    /*  78 */ "KeypadMinus",
+    /*  79 */ "F18",
+    /*  80 */ "F19",
+    /*  81 */ "KeypadEquals",
+    /*  82 */ "Keypad0",
+    /*  83 */ "Keypad1",
+    /*  84 */ "Keypad2",
+    /*  85 */ "Keypad3",
+    /*  86 */ "Keypad4",
+    /*  87 */ "Keypad5",
+    /*  88 */ "Keypad6",
+    /*  89 */ "Keypad7",
+    /*  90 */ "F20",
+    /*  91 */ "Keypad8",
+    /*  92 */ "Keypad9",
+    /*  93 */ "Yen",
+    /*  94 */ "Underscore",
+    /*  95 */ "KeypadComma",
+    /*  96 */ "F5",
+    /*  97 */ "F6",
+    /*  98 */ "F7",
+    /*  99 */ "F3",
+    /* 100 */ "F8",
+    /* 101 */ "F9",
+    /* 102 */ "Eisu",
+    /* 103 */ "F11",
+    /* 104 */ "Kana",
+    /* 105 */ "F13",
+    /* 106 */ "F16",
+    /* 107 */ "F14",
+    /* 108 */ NULL,
+    /* 109 */ "F10",
+    /* 110 */ NULL,
+    /* 111 */ "F12",
+    /* 112 */ NULL,
+    /* 113 */ "F15",
+    /* 114 */ "Help",
+    /* 115 */ "Home",
+    /* 116 */ "PageUp",
+    /* 117 */ "ForwardDelete",
+    /* 118 */ "F4",
+    /* 119 */ "End",
+    /* 120 */ "F2",
+    /* 121 */ "PageDown",
+    /* 122 */ "F1",
+    /* 123 */ "LeftArrow",
+    /* 124 */ "RightArrow",
+    /* 125 */ "DownArrow",
+    /* 126 */ "UpArrow",
+    /* 127 */ NULL,
+};
+
+#endif
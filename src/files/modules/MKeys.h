@@ -0,0 +1,22 @@
+#ifndef MKEYS_H
+#define MKEYS_H
+#include <strings.h>
+#include "MPlatform.h"
+#include "MKeyTable.h"
+
+// Case-insensitive name -> keycode. Returns 0 for unknown names.
+static inline int lookup_keycode(const char *name, CGKeyCode *code) {
+    uint32_t h = key_name_hash(name);
+    uint32_t d = key_hash_displacement[h % MKEY_HASH_BUCKETS];
+    const MKeySlot *slot = &key_hash_slots[key_slot_hash(h, d) & (MKEY_HASH_SLOTS - 1)];
+    if (!slot->name || strcasecmp(slot->name, name) != 0) return 0;
+    *code = (CGKeyCode)slot->code;
+    return 1;
+}
+
+// Canonical name for a keycode, or NULL.
+static inline const char *keycode_name(CGKeyCode code) {
+    return code < MKEY_MAX_CODE ? key_code_names[code] : NULL;
+}
+
+#endif
@@ -0,0 +1,298 @@
+#ifndef MLOADER_H
+#define MLOADER_H
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "MInterpreter.h"
+
+// Loads a single script, every .msr file in a directory, or the files listed
+// one per line in a .manifest/.list file (relative to the manifest's directory).
+// Files are read and parsed on a thread pool, then merged in path order into
+// one script. A hotkey or global defined by more than one file is reported,
+// and the first definition wins.
+
+#define MLOADER_MAX_THREADS 64
+
+typedef struct {
+    char *path;
+    MScript script;
+    size_t line_count;
+    size_t hotkey_count;
+    size_t error_count;
+    int read_failed;
+    double parse_ms;
+} MLoadUnit;
+
+// First declaration of each global, keyed by interned name.
+typedef struct {
+    const char *name;
+    const char *file;
+    size_t line;
+} MDeclOwner;
+
+typedef struct {
+    MDeclOwner *slots;
+    size_t mask;
+} MDeclOwners;
+
+typedef struct {
+    MLoadUnit *units;
+    size_t unit_count;
+    atomic_size_t next;
+} MLoadJob;
+
+static int has_suffix(const char *s, const char *suffix) {
+    size_t ls = strlen(s), lx = strlen(suffix);
+    return ls >= lx && strcmp(s + ls - lx, suffix) == 0;
+}
+
+static int is_manifest(const char *path) {
+    return has_suffix(path, ".manifest") || has_suffix(path, ".list");
+}
+
+static int compare_paths(const void *a, const void *b) {
+    return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+static int add_path(char ***paths, size_t *count, const char *dir, const char *name) {
+    char **grown = (char**)realloc(*paths, (*count + 1) * sizeof(char*));
+    if (!grown) return 0;
+    *paths = grown;
+
+    size_t len = (dir ? strlen(dir) + 1 : 0) + strlen(name) + 1;
+    char *full = (char*)malloc(len);
+    if (!full) return 0;
+    if (dir) snprintf(full, len, "%s/%s", dir, name);
+    else snprintf(full, len, "%s", name);
+    (*paths)[(*count)++] = full;
+    return 1;
+}
+
+static int collect_script_paths(const char *path, char ***paths, size_t *count) {
+    struct stat st;
+    if (stat(path, &st) != 0) { perror(path); return 0; }
+
+    if (S_ISDIR(st.st_mode)) {
+        DIR *d = opendir(path);
+        if (!d) { perror(path); return 0; }
+        struct dirent *ent;
+        while ((ent = readdir(d))) {
+            if (ent->d_name[0] != '.' && has_suffix(ent->d_name, ".msr"))
+                add_path(paths, count, path, ent->d_name);
+        }
+        closedir(d);
+        if (*count) qsort(*paths, *count, sizeof(char*), compare_paths);
+        return 1;
+    }
+
+    if (!is_manifest(path)) return add_path(paths, count, NULL, path);
+
+    MFile manifest = read_file(path);
+    if (!manifest.lines) return 0;
+
+    char *dir = strdup(path);
+    char *slash = dir ? strrchr(dir, '/') : NULL;
+    if (slash) *slash = '\0';
+
+    for (size_t i = 0; i < manifest.line_count; i++) {
+        char *entry = manifest.lines[i];
+        while (*entry && isspace((unsigned char)*entry)) entry++;
+        size_t len = strlen(entry);
+        while (len > 0 && isspace((unsigned char)entry[len - 1])) entry[--len] = '\0';
+        if (!len || entry[0] == '#') continue;
+        add_path(paths, count, (slash && entry[0] != '/') ? dir : NULL, entry);
+    }
+
+    free(dir);
+    free_mfile(&manifest);
+    return 1;
+}
+
+static void *load_worker(void *arg) {
+    MLoadJob *job = (MLoadJob*)arg;
+    for (;;) {
+        size_t i = atomic_fetch_add(&job->next, 1);
+        if (i >= job->unit_count) return NULL;
+
+        MLoadUnit *unit = &job->units[i];
+        uint64_t start = prof_now_ns();
+        MFile mf = read_file(unit->path);
+        if (!mf.lines) {
+            unit->read_failed = 1;
+        } else {
+            unit->line_count = mf.line_count;
+            unit->script = parse_script(&mf);
+            free_mfile(&mf);
+        }
+        unit->parse_ms = (prof_now_ns() - start) / 1e6;
+    }
+}
+
+static int init_decl_owners(MDeclOwners *owners, size_t decls) {
+    size_t capacity = 16;
+    while (capacity < decls * 2) capacity <<= 1;
+    owners->slots = (MDeclOwner*)calloc(capacity, sizeof(MDeclOwner));
+    owners->mask = capacity - 1;
+    return owners->slots != NULL;
+}
+
+static MDeclOwner *decl_owner_slot(MDeclOwners *owners, const char *name) {
+    size_t i = (size_t)(((uintptr_t)name >> 3) * 2654435761u) & owners->mask;
+    while (owners->slots[i].name && owners->slots[i].name != name) i = (i + 1) & owners->mask;
+    return &owners->slots[i];
+}
+
+static int loader_thread_count(size_t files) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus < 1) cpus = 1;
+    if (cpus > MLOADER_MAX_THREADS) cpus = MLOADER_MAX_THREADS;
+    return (size_t)cpus < files ? (int)cpus : (int)files;
+}
+
+// Moves unit's hotkeys and declarations into out, skipping any that an
+// earlier file already defined. Returns the number of conflicts.
+// owners maps a keycode to 1 + its index in out->hotkeys.
+static size_t merge_unit(MScript *out, MLoadUnit *unit, size_t *owners, MDeclOwners *decl_owners) {
+    size_t conflicts = 0;
+    MScript *s = &unit->script;
+
+    for (size_t i = 0; i < s->hotkey_count; i++) {
+        MHotkey *hk = &s->hotkeys[i];
+        hk->file = unit->path;
+        if (hk->has_code && hk->code < MKEY_MAX_CODE) {
+            const MHotkey *prev = owners[hk->code] ? &out->hotkeys[owners[hk->code] - 1] : NULL;
+            if (prev && prev->file != unit->path) {
+                fprintf(stderr, "%s:%zu: hotkey %s already defined at %s:%zu\n",
+                        unit->path, hk->line, hk->key, prev->file, prev->line);
+                free(hk->commands);
+                conflicts++;
+                continue;
+            }
+        }
+
+        MHotkey *grown = (MHotkey*)realloc(out->hotkeys, (out->hotkey_count + 1) * sizeof(MHotkey));
+        if (!grown) { free(hk->commands); continue; }
+        out->hotkeys = grown;
+        out->hotkeys[out->hotkey_count++] = *hk;
+        if (hk->has_code && hk->code < MKEY_MAX_CODE && !owners[hk->code])
+            owners[hk->code] = out->hotkey_count;
+    }
+
+    for (size_t i = 0; i < s->decl_count; i++) {
+        MDecl *d = &s->decls[i];
+        const char *name = intern(d->name);
+        if (!name) continue;
+        MDeclOwner *prev = decl_owner_slot(decl_owners, name);
+        if (prev->name && prev->file != unit->path) {
+            fprintf(stderr, "%s:%zu: global %s already declared at %s:%zu\n",
+                    unit->path, d->line, d->name, prev->file, prev->line);
+            conflicts++;
+            continue;
+        }
+
+        MDecl *grown = (MDecl*)realloc(out->decls, (out->decl_count + 1) * sizeof(MDecl));
+        if (!grown) continue;
+        out->decls = grown;
+        out->decls[out->decl_count++] = *d;
+        if (!prev->name) {
+            prev->name = name;
+            prev->file = unit->path;
+            prev->line = d->line;
+        }
+    }
+    return conflicts;
+}
+
+// Loads path into *out and defines its globals. Returns the number of
+// problems (unreadable files, parse errors and conflicts); the unreadable
+// files among them are also counted in *unreadable.
+static size_t load_scripts(const char *path, MScript *out, size_t *unreadable) {
+    memset(out, 0, sizeof(MScript));
+    uint64_t start = prof_now_ns();
+
+    char **paths = NULL;
+    size_t count = 0;
+    if (!collect_script_paths(path, &paths, &count) || !count) {
+        fprintf(stderr, "No scripts found at %s\n", path);
+        for (size_t i = 0; i < count; i++) free(paths[i]);
+        free(paths);
+        return 1;
+    }
+
+    MLoadJob job;
+    job.units = (MLoadUnit*)calloc(count, sizeof(MLoadUnit));
+    job.unit_count = count;
+    atomic_init(&job.next, 0);
+    if (!job.units) {
+        for (size_t i = 0; i < count; i++) free(paths[i]);
+        free(paths);
+        return 1;
+    }
+    for (size_t i = 0; i < count; i++) job.units[i].path = paths[i];
+
+    int threads = loader_thread_count(count);
+    pthread_t workers[MLOADER_MAX_THREADS];
+    int started = 0;
+    for (; started < threads - 1; started++) {
+        if (pthread_create(&workers[started], NULL, load_worker, &job) != 0) break;
+    }
+    load_worker(&job);
+    for (int i = 0; i < started; i++) pthread_join(workers[i], NULL);
+
+    size_t problems = 0, decl_total = 0;
+    for (size_t i = 0; i < count; i++) decl_total += job.units[i].script.decl_count;
+    size_t owners[MKEY_MAX_CODE] = {0};
+    MDeclOwners decl_owners;
+    int merging = init_decl_owners(&decl_owners, decl_total);
+
+    for (size_t i = 0; i < count; i++) {
+        MLoadUnit *unit = &job.units[i];
+        if (unit->read_failed) { problems++; (*unreadable)++; continue; }
+        unit->hotkey_count = unit->script.hotkey_count;
+        unit->error_count = unit->script.error_count;
+        print_parse_errors(&unit->script, unit->path);
+        problems += unit->script.error_count;
+        if (merging) problems += merge_unit(out, unit, owners, &decl_owners);
+
+        free(unit->script.hotkeys);
+        unit->script.hotkeys = NULL;
+        unit->script.hotkey_count = 0;
+        free_script(&unit->script);
+    }
+    free(decl_owners.slots);
+
+    out->files = paths;
+    out->file_count = count;
+    problems += resolve_script(out);
+    size_t dropped = apply_declarations(out);
+    if (dropped) {
+        fprintf(stderr, "out of memory: %zu globals were dropped\n", dropped);
+        problems += dropped;
+    }
+    double total_ms = (prof_now_ns() - start) / 1e6;
+
+    if (count > 1 || problems) {
+        fprintf(stderr, "=== LOAD ===\n");
+        for (size_t i = 0; i < count; i++) {
+            MLoadUnit *unit = &job.units[i];
+            if (unit->read_failed)
+                fprintf(stderr, "  %8.3f ms  %s: unreadable\n", unit->parse_ms, unit->path);
+            else
+                fprintf(stderr, "  %8.3f ms  %s: %zu lines, %zu hotkeys, %zu errors\n",
+                        unit->parse_ms, unit->path, unit->line_count, unit->hotkey_count, unit->error_count);
+        }
+        fprintf(stderr, "  %zu files, %zu hotkeys, %zu globals, %zu problems in %.3f ms on %d threads\n",
+                count, out->hotkey_count, (size_t)vstack[0].count, problems, total_ms, threads);
+        fprintf(stderr, "============\n");
+    }
+
+    free(job.units);
+    return problems;
+}
+
+#endif
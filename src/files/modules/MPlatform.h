@@ -0,0 +1,19 @@
+#ifndef MPLATFORM_H
+#define MPLATFORM_H
+
+#ifdef __APPLE__
+#include <ApplicationServices/ApplicationServices.h>
+#else
+// Headless builds (simulation only): just the CoreGraphics types the
+// interpreter and queue refer to. Nothing is ever posted to a display.
+#include <stdint.h>
+typedef uint16_t CGKeyCode;
+typedef uint32_t CGMouseButton;
+enum {
+    kCGMouseButtonLeft = 0,
+    kCGMouseButtonRight = 1,
+    kCGMouseButtonCenter = 2
+};
+#endif
+
+#endif
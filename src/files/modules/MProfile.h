@@ -0,0 +1,50 @@
+#ifndef MPROFILE_H
+#define MPROFILE_H
+#include <stdint.h>
+#include <time.h>
+
+#define MPROF_MAX_EVENTS 16
+#define MPROF_DEFAULT_PATH "machk.folded"
+#define MPROF_TOP_N 10
+#define MPROF_FLUSH_SECONDS 60
+
+// Every execution is counted; only one in `sample_every` is timed, and
+// reports scale the sampled time up to the full count.
+typedef struct {
+    uint64_t count;
+    uint64_t sampled;
+    uint64_t ns;
+} MProfStat;
+
+static struct
+{
+    int enabled;
+    uint32_t sample_every;
+    MProfStat events[MPROF_MAX_EVENTS];
+} MProfiler = { .sample_every = 1 };
+
+static inline uint64_t prof_now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// Returns a start timestamp when this execution is sampled, 0 otherwise.
+static inline uint64_t prof_begin(MProfStat *s) {
+    if (!MProfiler.enabled) return 0;
+    if (s->count++ % MProfiler.sample_every) return 0;
+    return prof_now_ns();
+}
+
+static inline void prof_end(MProfStat *s, uint64_t start) {
+    if (!start) return;
+    s->sampled++;
+    s->ns += prof_now_ns() - start;
+}
+
+static inline uint64_t prof_estimate_ns(const MProfStat *s) {
+    if (!s->sampled) return 0;
+    return (uint64_t)((double)s->ns * s->count / s->sampled);
+}
+
+#endif
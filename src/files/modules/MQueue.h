@@ -1,14 +1,27 @@
 #ifndef MQUEUE_H
 #define MQUEUE_H
-#include <ApplicationServices/ApplicationServices.h>
+#include "MPlatform.h"
+#include "MKeys.h"
+#include "MProfile.h"
 #include <unistd.h>
 
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <stdarg.h>
+
+// Timeout of one main run loop iteration; process() runs once per iteration.
+#define M_RUNLOOP_INTERVAL 0.1
+// Stored in kCGEventSourceUserData of every key event we post, so the
+// hotkey tap can tell them apart from real keystrokes.
+#define M_EVENT_TAG 0x4D61634848
+
+#ifdef __APPLE__
 void initialize()
 {
     CGDisplayShowCursor(kCGDirectMainDisplay);
 }
+#endif
 typedef enum
 {
     M_Success,
@@ -23,6 +36,8 @@ typedef enum
     _F(MouseDown, 1, __VA_ARGS__) \
     _F(MouseMove, 2, __VA_ARGS__) \
     _F(MouseClick, 3, __VA_ARGS__) \
+    _F(KeyDown, 4, __VA_ARGS__) \
+    _F(KeyUp, 5, __VA_ARGS__) \
 
 #define types_enum(uc, i, ...) \
     MEvent_##uc = i,
@@ -31,11 +46,18 @@ typedef enum MEventType {
     _iter(types_enum)
 } MEventType;
 
+static inline MProfStat* prof_event(MEventType type)
+{
+    return &MProfiler.events[type - MEvent_Empty];
+}
+
 
 typedef struct MouseUp { int x, y; CGMouseButton clickType; } MouseUp_t;
 typedef struct MouseClick { int x, y; CGMouseButton clickType; } MouseClick_t;
 typedef struct MouseDown { int x, y; CGMouseButton clickType; } MouseDown_t;
 typedef struct MouseMove { int x, y; float duration; } MouseMove_t;
+typedef struct KeyDown { CGKeyCode code; } KeyDown_t;
+typedef struct KeyUp { CGKeyCode code; } KeyUp_t;
 typedef struct { char empty; } Empty_t;
 
 typedef struct {
@@ -52,6 +74,8 @@ struct
 {
     MQueueNode* nodes;
     int nodeCount;
+    int head;
+    int capacity;
 } MDataQueue;
 
 MQueueNode create_node(MEventType type, ...)
@@ -93,6 +117,16 @@ MQueueNode create_node(MEventType type, ...)
             node.MouseMove.duration = va_arg(args, double);
             break;
         }
+        case MEvent_KeyDown:
+        {
+            node.KeyDown.code = (CGKeyCode)va_arg(args, int);
+            break;
+        }
+        case MEvent_KeyUp:
+        {
+            node.KeyUp.code = (CGKeyCode)va_arg(args, int);
+            break;
+        }
     }
     va_end(args);
 
@@ -102,16 +136,31 @@ MQueueNode create_node(MEventType type, ...)
 void destroy_nodes()
 {
     free(MDataQueue.nodes);
+    MDataQueue.nodes = NULL;
+    MDataQueue.nodeCount = 0;
+    MDataQueue.head = 0;
+    MDataQueue.capacity = 0;
 }
 int push_node(MQueueNode node)
 {
-    MQueueNode* new_nodes =
-        realloc(MDataQueue.nodes, sizeof(MQueueNode) * (MDataQueue.nodeCount + 1));
+    if (MDataQueue.head + MDataQueue.nodeCount == MDataQueue.capacity) {
+        if (MDataQueue.head > 0) {
+            memmove(MDataQueue.nodes, MDataQueue.nodes + MDataQueue.head,
+                    sizeof(MQueueNode) * MDataQueue.nodeCount);
+            MDataQueue.head = 0;
+        } else {
+            int capacity = MDataQueue.capacity ? MDataQueue.capacity * 2 : 16;
+            MQueueNode* new_nodes =
+                realloc(MDataQueue.nodes, sizeof(MQueueNode) * capacity);
+
+            if (!new_nodes) return M_MemoryFailure;
 
-    if (!new_nodes) return M_MemoryFailure;
+            MDataQueue.nodes = new_nodes;
+            MDataQueue.capacity = capacity;
+        }
+    }
 
-    MDataQueue.nodes = new_nodes;
-    MDataQueue.nodes[MDataQueue.nodeCount++] = node;
+    MDataQueue.nodes[MDataQueue.head + MDataQueue.nodeCount++] = node;
     return M_Success;
 }
 
@@ -124,30 +173,57 @@ MQueueNode pop_node()
         return empty; 
     }
 
-    MQueueNode node = MDataQueue.nodes[MDataQueue.nodeCount - 1];
+    MQueueNode node = MDataQueue.nodes[MDataQueue.head++];
     MDataQueue.nodeCount--;
 
-    if (MDataQueue.nodeCount == 0) {
-        free(MDataQueue.nodes);
-        MDataQueue.nodes = NULL;
-    } else {
-        MQueueNode* new_nodes =
-            realloc(MDataQueue.nodes, sizeof(MQueueNode) * MDataQueue.nodeCount);
-        if (new_nodes) MDataQueue.nodes = new_nodes;
-    }
+    if (MDataQueue.nodeCount == 0) MDataQueue.head = 0;
 
     return node;
 }
 
+#define types_name(uc, i, ...) case MEvent_##uc: return #uc;
 
+const char* node_type_name(MEventType type)
+{
+    switch(type)
+    {
+        _iter(types_name)
+    }
+    return "Unknown";
+}
 
-void process()
+int format_node(const MQueueNode* node, char* buf, size_t size)
 {
-    MQueueNode node = pop_node();
-    if(node.type == MEvent_Empty)
+    switch(node->type)
     {
-        return;
+        case MEvent_MouseClick:
+            return snprintf(buf, size, "MouseClick %d %d %u",
+                            node->MouseClick.x, node->MouseClick.y, (unsigned)node->MouseClick.clickType);
+        case MEvent_MouseDown:
+            return snprintf(buf, size, "MouseDown %d %d %u",
+                            node->MouseDown.x, node->MouseDown.y, (unsigned)node->MouseDown.clickType);
+        case MEvent_MouseUp:
+            return snprintf(buf, size, "MouseUp %d %d %u",
+                            node->MouseUp.x, node->MouseUp.y, (unsigned)node->MouseUp.clickType);
+        case MEvent_MouseMove:
+            return snprintf(buf, size, "MouseMove %d %d %.2f",
+                            node->MouseMove.x, node->MouseMove.y, node->MouseMove.duration);
+        case MEvent_KeyDown:
+        case MEvent_KeyUp: {
+            CGKeyCode code = node->type == MEvent_KeyDown ? node->KeyDown.code : node->KeyUp.code;
+            const char* name = keycode_name(code);
+            if (name) return snprintf(buf, size, "%s %s", node_type_name(node->type), name);
+            return snprintf(buf, size, "%s %u", node_type_name(node->type), (unsigned)code);
+        }
+        default:
+            return snprintf(buf, size, "%s", node_type_name(node->type));
     }
+}
+
+
+#ifdef __APPLE__
+void post_node(MQueueNode node)
+{
     switch(node.type)
     {
         default:
@@ -156,15 +232,16 @@ void process()
         }
         case MEvent_MouseClick: {
             //printf("Clicking...\n");
+            int right = node.MouseClick.clickType == kCGMouseButtonRight;
             CGEventRef click1_down = CGEventCreateMouseEvent(
-                NULL, kCGEventLeftMouseDown,
+                NULL, right ? kCGEventRightMouseDown : kCGEventLeftMouseDown,
                 CGPointMake(node.MouseClick.x, node.MouseClick.y),
-                kCGMouseButtonLeft
+                node.MouseClick.clickType
             );
             CGEventRef click1_up = CGEventCreateMouseEvent(
-                NULL, kCGEventLeftMouseUp,
+                NULL, right ? kCGEventRightMouseUp : kCGEventLeftMouseUp,
                 CGPointMake(node.MouseClick.x, node.MouseClick.y),
-                kCGMouseButtonLeft
+                node.MouseClick.clickType
             );
             CGEventPost(kCGHIDEventTap, click1_down);
             CGEventPost(kCGHIDEventTap, click1_up);
@@ -210,16 +287,38 @@ void process()
             //printf("Moving...\n");
             CGEventRef event = CGEventCreateMouseEvent(
                 NULL, kCGEventMouseMoved,
-                CGPointMake(node.MouseMove.x, node.MouseUp.y),
+                CGPointMake(node.MouseMove.x, node.MouseMove.y),
                 kCGMouseButtonLeft
             );
             CGEventPost(kCGHIDEventTap, event);
             CFRelease(event);
         } break;
+        case MEvent_KeyDown:
+        case MEvent_KeyUp: {
+            CGKeyCode code = node.type == MEvent_KeyDown ? node.KeyDown.code : node.KeyUp.code;
+            CGEventRef event = CGEventCreateKeyboardEvent(NULL, code, node.type == MEvent_KeyDown);
+            CGEventSetIntegerValueField(event, kCGEventSourceUserData, M_EVENT_TAG);
+            CGEventPost(kCGHIDEventTap, event);
+            CFRelease(event);
+        } break;
 
 
     }
 }
 
+void process()
+{
+    MQueueNode node = pop_node();
+    if(node.type == MEvent_Empty)
+    {
+        return;
+    }
+    MProfStat* stat = prof_event(node.type);
+    uint64_t start = prof_begin(stat);
+    post_node(node);
+    prof_end(stat, start);
+}
+#endif
+
 
 #endif
\ No newline at end of file
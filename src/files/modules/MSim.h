@@ -0,0 +1,250 @@
+#ifndef MSIM_H
+#define MSIM_H
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdint.h>
+#include <time.h>
+#include "MQueue.h"
+#include "MInterpreter.h"
+
+// Replays a key stream through dispatch_key() on a virtual clock and
+// records every node that process() would have posted.
+//
+// Key stream lines: "<delay_ms> <Key> [count]". The key is pressed count
+// times (default 1), delay_ms after the previous press. '#' starts a comment.
+// A line that does not parse or names an unknown key is reported, and the
+// run fails even if the rest matches the golden trace.
+//
+// The clock models the main loop: dispatching a key returns from the run
+// loop and process() posts one node; while nodes remain queued, process()
+// runs again every M_RUNLOOP_INTERVAL. Commands themselves take zero time.
+
+#define MSIM_TICK_NS ((uint64_t)(M_RUNLOOP_INTERVAL * 1e9))
+
+typedef struct {
+    uint64_t delay_ns;
+    uint64_t count;
+    CGKeyCode code;
+    size_t line;
+} MSimStep;
+
+typedef struct {
+    MSimStep *steps;
+    size_t step_count;
+    size_t bad_lines;
+} MKeyStream;
+
+typedef struct {
+    FILE *trace;        // actual trace output, may be NULL
+    FILE *golden;       // expected trace, may be NULL
+    size_t golden_line;
+    size_t mismatches;
+    size_t first_mismatch;
+    char expected[128];
+    char actual[128];
+
+    uint64_t presses;
+    uint64_t nodes;
+    uint64_t now_ns;
+} MSim;
+
+static MKeyStream read_key_stream(const char *filename) {
+    MKeyStream ks = {0};
+    MFile mf = read_file(filename);
+    if (!mf.lines) return ks;
+
+    for (size_t i = 0; i < mf.line_count; i++) {
+        char *line = mf.lines[i];
+        char *hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+
+        double delay_ms;
+        char key[32];
+        int used = 0;
+        int n = sscanf(line, " %lf %31s%n", &delay_ms, key, &used);
+        if (n == EOF) continue;
+
+        unsigned long long count = 1;
+        char *rest = line + used, *end;
+        while (*rest && isspace((unsigned char)*rest)) rest++;
+        if (n == 2 && *rest) {
+            count = strtoull(rest, &end, 10);
+            if (end == rest) n = 0;
+            for (rest = end; *rest && isspace((unsigned char)*rest); rest++) {}
+            if (*rest) n = 0;
+        }
+        if (n < 2 || delay_ms < 0) {
+            fprintf(stderr, "%s:%zu: expected \"<delay_ms> <Key> [count]\"\n", filename, i + 1);
+            ks.bad_lines++;
+            continue;
+        }
+
+        CGKeyCode code;
+        if (!lookup_keycode(key, &code)) {
+            fprintf(stderr, "%s:%zu: unknown key '%s'\n", filename, i + 1, key);
+            ks.bad_lines++;
+            continue;
+        }
+
+        MSimStep *steps = (MSimStep*)realloc(ks.steps, (ks.step_count + 1) * sizeof(MSimStep));
+        if (!steps) break;
+        ks.steps = steps;
+        ks.steps[ks.step_count].delay_ns = (uint64_t)(delay_ms * 1e6);
+        ks.steps[ks.step_count].count = count;
+        ks.steps[ks.step_count].code = code;
+        ks.steps[ks.step_count].line = i + 1;
+        ks.step_count++;
+    }
+
+    free_mfile(&mf);
+    return ks;
+}
+
+static void free_key_stream(MKeyStream *ks) {
+    free(ks->steps);
+    ks->steps = NULL;
+    ks->step_count = 0;
+}
+
+static int sim_next_golden(MSim *sim, char *buf, size_t size) {
+    while (fgets(buf, (int)size, sim->golden)) {
+        sim->golden_line++;
+        buf[strcspn(buf, "\r\n")] = '\0';
+        if (buf[0] == '\0' || buf[0] == '#') continue;
+        return 1;
+    }
+    return 0;
+}
+
+static void sim_mismatch(MSim *sim, const char *expected, const char *actual) {
+    if (!sim->mismatches++) {
+        sim->first_mismatch = sim->golden_line;
+        snprintf(sim->expected, sizeof(sim->expected), "%s", expected);
+        snprintf(sim->actual, sizeof(sim->actual), "%s", actual);
+    }
+}
+
+static int sim_format_u64(uint64_t v, char *buf) {
+    char tmp[20];
+    int n = 0;
+    do { tmp[n++] = (char)('0' + v % 10); v /= 10; } while (v);
+    for (int i = 0; i < n; i++) buf[i] = tmp[n - 1 - i];
+    return n;
+}
+
+static void sim_emit(MSim *sim, const MQueueNode *node) {
+    char line[128];
+    int n = sim_format_u64(sim->now_ns, line);
+    line[n++] = ' ';
+    n += format_node(node, line + n, sizeof(line) - n);
+    if (n > (int)sizeof(line) - 2) n = sizeof(line) - 2;
+    sim->nodes++;
+
+    if (sim->trace) {
+        line[n] = '\n';
+        fwrite(line, 1, n + 1, sim->trace);
+        line[n] = '\0';
+    }
+    if (sim->golden) {
+        char expected[128];
+        if (!sim_next_golden(sim, expected, sizeof(expected))) sim_mismatch(sim, "<end of trace>", line);
+        else if (strcmp(expected, line) != 0) sim_mismatch(sim, expected, line);
+    }
+}
+
+static void sim_process(MSim *sim) {
+    MQueueNode node = pop_node();
+    if (node.type == MEvent_Empty) return;
+
+    MProfStat *stat = prof_event(node.type);
+    uint64_t start = prof_begin(stat);
+    sim_emit(sim, &node);
+    prof_end(stat, start);
+}
+
+// Runs idle loop iterations until the next one would start after `until`.
+static void sim_idle(MSim *sim, uint64_t *loop_ns, uint64_t until) {
+    while (MDataQueue.nodeCount > 0 && *loop_ns + MSIM_TICK_NS <= until) {
+        *loop_ns += MSIM_TICK_NS;
+        sim->now_ns = *loop_ns;
+        sim_process(sim);
+    }
+}
+
+static void run_key_stream(MSim *sim, MScript *script, const MKeyStream *ks) {
+    uint64_t loop_ns = sim->now_ns;
+    for (size_t i = 0; i < ks->step_count; i++) {
+        const MSimStep *step = &ks->steps[i];
+        for (uint64_t k = 0; k < step->count; k++) {
+            uint64_t at = sim->now_ns + step->delay_ns;
+            sim_idle(sim, &loop_ns, at);
+
+            sim->now_ns = loop_ns = at;
+            dispatch_key(script, step->code);
+            sim->presses++;
+            sim_process(sim);
+        }
+    }
+    sim_idle(sim, &loop_ns, UINT64_MAX);
+}
+
+static double sim_wall_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Returns 0 when the run matches golden_path (or no golden was given).
+static int run_simulation(MScript *script, const char *keys_path, const char *golden_path) {
+    MKeyStream ks = read_key_stream(keys_path);
+    if (!ks.steps) {
+        fprintf(stderr, "No key events in %s\n", keys_path);
+        return 1;
+    }
+
+    MSim sim;
+    memset(&sim, 0, sizeof(sim));
+    if (golden_path) {
+        sim.golden = fopen(golden_path, "r");
+        if (!sim.golden) { perror("Failed to open golden trace"); free_key_stream(&ks); return 1; }
+    } else {
+        sim.trace = stdout;
+        setvbuf(stdout, NULL, _IOFBF, 1 << 16);
+    }
+
+    double start = sim_wall_seconds();
+    run_key_stream(&sim, script, &ks);
+    double elapsed = sim_wall_seconds() - start;
+
+    if (sim.golden) {
+        char extra[128];
+        if (sim_next_golden(&sim, extra, sizeof(extra))) sim_mismatch(&sim, extra, "<end of trace>");
+        fclose(sim.golden);
+    }
+
+    fprintf(stderr, "=== SIMULATION ===\n");
+    fprintf(stderr, "  presses: %llu, nodes: %llu, virtual time: %.3f s\n",
+            (unsigned long long)sim.presses, (unsigned long long)sim.nodes, sim.now_ns / 1e9);
+    fprintf(stderr, "  wall time: %.3f s (%.0f presses/s)\n",
+            elapsed, elapsed > 0 ? sim.presses / elapsed : 0.0);
+    if (golden_path) {
+        if (sim.mismatches) {
+            fprintf(stderr, "  FAIL: %zu mismatching lines, first at %s:%zu\n",
+                    sim.mismatches, golden_path, sim.first_mismatch);
+            fprintf(stderr, "    expected: %s\n    actual:   %s\n", sim.expected, sim.actual);
+        } else {
+            fprintf(stderr, "  OK: matches %s\n", golden_path);
+        }
+    }
+    if (ks.bad_lines)
+        fprintf(stderr, "  FAIL: %zu bad lines in %s\n", ks.bad_lines, keys_path);
+    fprintf(stderr, "==================\n");
+
+    int failed = sim.mismatches || ks.bad_lines;
+    free_key_stream(&ks);
+    return failed ? 1 : 0;
+}
+
+#endif
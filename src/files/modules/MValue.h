@@ -0,0 +1,312 @@
+#ifndef MVALUE_H
+#define MVALUE_H
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <limits.h>
+
+#define _val_iter(_F, ...)          \
+    _F(Int, 0, __VA_ARGS__)         \
+    _F(Float, 1, __VA_ARGS__)       \
+    _F(Bool, 2, __VA_ARGS__)        \
+    _F(String, 3, __VA_ARGS__)      \
+
+#define vtypes_enum(name, val, ...) MValueType_##name = val,
+
+typedef enum { _val_iter(vtypes_enum) } MValueType;
+
+// 16 bytes: tag + payload. String payloads are preceded by an MStrHeader.
+// Literals and names are interned once at load time and never freed; strings
+// built while running (concatenation, conversion) are refcounted.
+//
+// Ownership: an MValue returned by eval or a value_* constructor is owned by
+// the caller. set_var() takes ownership, reading a variable retains, and
+// value_concat/value_arith/value_as_string consume their operands.
+typedef struct {
+    MValueType type;
+    union {
+        int64_t i;
+        double f;
+        int b;
+        const char *s;
+    };
+} MValue;
+
+typedef struct {
+    uint32_t refs;
+    uint32_t len;
+} MStrHeader;
+
+#define MSTR_IMMORTAL UINT32_MAX
+
+static inline MStrHeader *str_header(const char *s) {
+    return (MStrHeader*)(s - sizeof(MStrHeader));
+}
+
+static char *str_alloc(const char *s, size_t len, uint32_t refs) {
+    MStrHeader *h = (MStrHeader*)malloc(sizeof(MStrHeader) + len + 1);
+    if (!h) return NULL;
+    h->refs = refs;
+    h->len = (uint32_t)len;
+    char *copy = (char*)(h + 1);
+    memcpy(copy, s, len);
+    copy[len] = '\0';
+    return copy;
+}
+
+typedef struct {
+    const char *str;
+    uint32_t hash;
+    uint32_t len;
+} MInternSlot;
+
+static struct
+{
+    MInternSlot *slots;
+    size_t capacity;
+    size_t count;
+} MInternTable;
+
+static uint32_t intern_hash(const char *s, size_t len) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        h ^= (unsigned char)s[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static MInternSlot *intern_slot(const char *s, size_t len, uint32_t hash) {
+    size_t mask = MInternTable.capacity - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        MInternSlot *slot = &MInternTable.slots[i];
+        if (!slot->str) return slot;
+        if (slot->hash == hash && slot->len == len && memcmp(slot->str, s, len) == 0)
+            return slot;
+    }
+}
+
+static int intern_grow() {
+    size_t capacity = MInternTable.capacity ? MInternTable.capacity * 2 : 64;
+    MInternSlot *old = MInternTable.slots;
+    size_t old_capacity = MInternTable.capacity;
+
+    MInternTable.slots = (MInternSlot*)calloc(capacity, sizeof(MInternSlot));
+    if (!MInternTable.slots) {
+        MInternTable.slots = old;
+        return 0;
+    }
+    MInternTable.capacity = capacity;
+
+    for (size_t i = 0; i < old_capacity; i++) {
+        if (!old[i].str) continue;
+        *intern_slot(old[i].str, old[i].len, old[i].hash) = old[i];
+    }
+    free(old);
+    return 1;
+}
+
+static const char *intern_n(const char *s, size_t len) {
+    if ((MInternTable.count + 1) * 2 > MInternTable.capacity && !intern_grow()) return NULL;
+
+    uint32_t hash = intern_hash(s, len);
+    MInternSlot *slot = intern_slot(s, len, hash);
+    if (slot->str) return slot->str;
+
+    char *copy = str_alloc(s, len, MSTR_IMMORTAL);
+    if (!copy) return NULL;
+
+    slot->str = copy;
+    slot->hash = hash;
+    slot->len = (uint32_t)len;
+    MInternTable.count++;
+    return copy;
+}
+
+static const char *intern(const char *s) {
+    return intern_n(s, strlen(s));
+}
+
+static void free_interns() {
+    for (size_t i = 0; i < MInternTable.capacity; i++) {
+        if (MInternTable.slots[i].str) free(str_header(MInternTable.slots[i].str));
+    }
+    free(MInternTable.slots);
+    MInternTable.slots = NULL;
+    MInternTable.capacity = 0;
+    MInternTable.count = 0;
+}
+
+static inline MValue value_int(int64_t i)   { MValue v; v.type = MValueType_Int; v.i = i; return v; }
+static inline MValue value_float(double f)  { MValue v; v.type = MValueType_Float; v.f = f; return v; }
+static inline MValue value_bool(int b)      { MValue v; v.type = MValueType_Bool; v.b = b != 0; return v; }
+static inline MValue value_str(const char *interned) {
+    MValue v;
+    v.type = MValueType_String;
+    v.s = interned ? interned : intern("");
+    return v;
+}
+
+static inline void value_retain(MValue v) {
+    if (v.type != MValueType_String) return;
+    MStrHeader *h = str_header(v.s);
+    if (h->refs != MSTR_IMMORTAL) h->refs++;
+}
+
+static inline void value_release(MValue v) {
+    if (v.type != MValueType_String) return;
+    MStrHeader *h = str_header(v.s);
+    if (h->refs != MSTR_IMMORTAL && --h->refs == 0) free(h);
+}
+
+// A fresh runtime string with one reference.
+static MValue value_str_n(const char *s, size_t len) {
+    char *copy = str_alloc(s, len, 1);
+    return copy ? value_str(copy) : value_str(NULL);
+}
+
+// Int arithmetic wraps around like two's complement instead of overflowing.
+static inline int64_t int_add(int64_t x, int64_t y) { return (int64_t)((uint64_t)x + (uint64_t)y); }
+static inline int64_t int_sub(int64_t x, int64_t y) { return (int64_t)((uint64_t)x - (uint64_t)y); }
+static inline int64_t int_mul(int64_t x, int64_t y) { return (int64_t)((uint64_t)x * (uint64_t)y); }
+static inline int64_t int_neg(int64_t x)            { return (int64_t)(0 - (uint64_t)x); }
+static inline int64_t int_div(int64_t x, int64_t y) {
+    if (!y) return 0;
+    return y == -1 ? int_neg(x) : x / y;
+}
+
+// Saturates instead of converting NaN or out-of-range floats, which is undefined.
+static inline int64_t float_to_int(double f) {
+    if (isnan(f)) return 0;
+    if (f >= 9223372036854775807.0) return INT64_MAX;
+    if (f <= -9223372036854775808.0) return INT64_MIN;
+    return (int64_t)f;
+}
+
+static inline int64_t value_as_int(MValue v) {
+    switch (v.type) {
+        case MValueType_Int:    return v.i;
+        case MValueType_Float:  return float_to_int(v.f);
+        case MValueType_Bool:   return v.b;
+        case MValueType_String: return strtoll(v.s, NULL, 10);
+    }
+    return 0;
+}
+
+static inline double value_as_double(MValue v) {
+    switch (v.type) {
+        case MValueType_Int:    return (double)v.i;
+        case MValueType_Float:  return v.f;
+        case MValueType_Bool:   return v.b;
+        case MValueType_String: return strtod(v.s, NULL);
+    }
+    return 0.0;
+}
+
+static inline int value_truthy(MValue v) {
+    switch (v.type) {
+        case MValueType_Int:    return v.i != 0;
+        case MValueType_Float:  return v.f != 0.0;
+        case MValueType_Bool:   return v.b;
+        case MValueType_String: return v.s[0] != '\0';
+    }
+    return 0;
+}
+
+static int value_format(MValue v, char *buf, size_t size) {
+    switch (v.type) {
+        case MValueType_Int:    return snprintf(buf, size, "%lld", (long long)v.i);
+        case MValueType_Float:  return snprintf(buf, size, "%g", v.f);
+        case MValueType_Bool:   return snprintf(buf, size, "%s", v.b ? "true" : "false");
+        case MValueType_String: return snprintf(buf, size, "%s", v.s);
+    }
+    return 0;
+}
+
+static MValue value_as_string(MValue v) {
+    if (v.type == MValueType_String) return v;
+    char buf[64];
+    int n = value_format(v, buf, sizeof(buf));
+    return value_str_n(buf, n < (int)sizeof(buf) ? (size_t)n : sizeof(buf) - 1);
+}
+
+static int value_equals(MValue a, MValue b) {
+    if (a.type == b.type) {
+        switch (a.type) {
+            case MValueType_Int:    return a.i == b.i;
+            case MValueType_Float:  return a.f == b.f;
+            case MValueType_Bool:   return a.b == b.b;
+            case MValueType_String: {
+                if (a.s == b.s) return 1;
+                const MStrHeader *x = str_header(a.s), *y = str_header(b.s);
+                // Two interned strings are equal only if they are the same pointer.
+                if (x->refs == MSTR_IMMORTAL && y->refs == MSTR_IMMORTAL) return 0;
+                return x->len == y->len && memcmp(a.s, b.s, x->len) == 0;
+            }
+        }
+    }
+    if (a.type == MValueType_String || b.type == MValueType_String) return 0;
+    return value_as_double(a) == value_as_double(b);
+}
+
+static MValue value_concat(MValue a, MValue b) {
+    a = value_as_string(a);
+    b = value_as_string(b);
+    size_t la = str_header(a.s)->len, lb = str_header(b.s)->len;
+
+    MStrHeader *h = (MStrHeader*)malloc(sizeof(MStrHeader) + la + lb + 1);
+    if (!h) { value_release(b); return a; }
+    h->refs = 1;
+    h->len = (uint32_t)(la + lb);
+    char *buf = (char*)(h + 1);
+    memcpy(buf, a.s, la);
+    memcpy(buf + la, b.s, lb);
+    buf[la + lb] = '\0';
+
+    value_release(a);
+    value_release(b);
+    return value_str(buf);
+}
+
+// Slow path for everything that is not int op int; callers handle that inline.
+static MValue value_arith(char op, MValue a, MValue b) {
+    if (op == '+' && (a.type == MValueType_String || b.type == MValueType_String))
+        return value_concat(a, b);
+
+    if (a.type != MValueType_Float && b.type != MValueType_Float) {
+        int64_t x = value_as_int(a), y = value_as_int(b);
+        value_release(a);
+        value_release(b);
+        switch (op) {
+            case '+': return value_int(int_add(x, y));
+            case '-': return value_int(int_sub(x, y));
+            case '*': return value_int(int_mul(x, y));
+            case '/': return value_int(int_div(x, y));
+        }
+        return value_int(0);
+    }
+
+    double x = value_as_double(a), y = value_as_double(b);
+    value_release(a);
+    value_release(b);
+    switch (op) {
+        case '+': return value_float(x + y);
+        case '-': return value_float(x - y);
+        case '*': return value_float(x * y);
+        case '/': return value_float(x / y);
+    }
+    return value_float(0.0);
+}
+
+static void print_value(MValue v) {
+    switch (v.type) {
+        case MValueType_Int:    printf("%lld", (long long)v.i); break;
+        case MValueType_Float:  printf("%g", v.f); break;
+        case MValueType_Bool:   printf("%s", v.b ? "true" : "false"); break;
+        case MValueType_String: printf("\"%s\"", v.s); break;
+    }
+}
+
+#endif
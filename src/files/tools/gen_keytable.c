@@ -0,0 +1,158 @@
+// Generates modules/MKeyTable.h from the key lists in MKeyNames.h:
+//
+//   cc tools/gen_keytable.c -I modules -o gen_keytable && ./gen_keytable > modules/MKeyTable.h
+//
+// Lookup is a two-level perfect hash (hash and displace): the name hash picks
+// a bucket, and the bucket's displacement picks a slot that no other name uses.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include "MKeyNames.h"
+
+typedef struct {
+    const char *name;
+    int code;
+    int canonical;
+    uint32_t hash;
+} Entry;
+
+#define entry_canonical(name, code, ...) { name, code, 1, 0 },
+#define entry_alias(name, code, ...) { name, code, 0, 0 },
+
+static Entry entries[] = {
+    _key_iter(entry_canonical)
+    _key_alias_iter(entry_alias)
+};
+#define ENTRY_COUNT (sizeof(entries) / sizeof(entries[0]))
+
+static size_t bucket_count;
+static size_t *bucket_sizes;
+
+static int compare_buckets(const void *a, const void *b) {
+    size_t x = bucket_sizes[*(const size_t*)a], y = bucket_sizes[*(const size_t*)b];
+    return (x < y) - (x > y);
+}
+
+static void print_literal(const char *s) {
+    putchar('"');
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\') putchar('\\');
+        putchar(*s);
+    }
+    putchar('"');
+}
+
+int main() {
+    const char *code_names[MKEY_MAX_CODE] = {0};
+
+    for (size_t i = 0; i < ENTRY_COUNT; i++) {
+        Entry *e = &entries[i];
+        if (e->code < 0 || e->code >= MKEY_MAX_CODE || strlen(e->name) >= MKEY_MAX_NAME) {
+            fprintf(stderr, "bad key entry '%s' (%d)\n", e->name, e->code);
+            return 1;
+        }
+        for (size_t j = 0; j < i; j++) {
+            if (strcasecmp(entries[j].name, e->name) == 0) {
+                fprintf(stderr, "duplicate key name '%s'\n", e->name);
+                return 1;
+            }
+        }
+        if (e->canonical) {
+            if (code_names[e->code]) {
+                fprintf(stderr, "keycode %d has two canonical names\n", e->code);
+                return 1;
+            }
+            code_names[e->code] = e->name;
+        }
+        e->hash = key_name_hash(e->name);
+    }
+
+    for (size_t i = 0; i < ENTRY_COUNT; i++) {
+        if (!code_names[entries[i].code]) {
+            fprintf(stderr, "alias '%s' has no canonical name for keycode %d\n", entries[i].name, entries[i].code);
+            return 1;
+        }
+    }
+
+    size_t slot_count = 1;
+    while (slot_count < ENTRY_COUNT + ENTRY_COUNT / 4) slot_count <<= 1;
+    bucket_count = ENTRY_COUNT / 2 + 1;
+
+    bucket_sizes = calloc(bucket_count, sizeof(size_t));
+    size_t *order = malloc(bucket_count * sizeof(size_t));
+    uint16_t *displacement = calloc(bucket_count, sizeof(uint16_t));
+    int *slots = malloc(slot_count * sizeof(int));
+    int *trial = malloc(ENTRY_COUNT * sizeof(int));
+    if (!bucket_sizes || !order || !displacement || !slots || !trial) return 1;
+
+    for (size_t i = 0; i < slot_count; i++) slots[i] = -1;
+    for (size_t i = 0; i < ENTRY_COUNT; i++) bucket_sizes[entries[i].hash % bucket_count]++;
+    for (size_t b = 0; b < bucket_count; b++) order[b] = b;
+    qsort(order, bucket_count, sizeof(size_t), compare_buckets);
+
+    for (size_t k = 0; k < bucket_count && bucket_sizes[order[k]]; k++) {
+        size_t b = order[k];
+        uint32_t d;
+        for (d = 1; d <= UINT16_MAX; d++) {
+            size_t placed = 0;
+            for (size_t i = 0; i < ENTRY_COUNT; i++) {
+                if (entries[i].hash % bucket_count != b) continue;
+                size_t s = key_slot_hash(entries[i].hash, d) & (slot_count - 1);
+                int taken = slots[s] != -1;
+                for (size_t p = 0; p < placed && !taken; p++) taken = (size_t)trial[p] == s;
+                if (taken) break;
+                trial[placed++] = (int)s;
+            }
+            if (placed == bucket_sizes[b]) break;
+        }
+        if (d > UINT16_MAX) {
+            fprintf(stderr, "no displacement found for bucket %zu\n", b);
+            return 1;
+        }
+
+        displacement[b] = (uint16_t)d;
+        size_t placed = 0;
+        for (size_t i = 0; i < ENTRY_COUNT; i++) {
+            if (entries[i].hash % bucket_count == b) slots[trial[placed++]] = (int)i;
+        }
+    }
+
+    printf("// Generated by tools/gen_keytable.c from MKeyNames.h. Do not edit.\n");
+    printf("#ifndef MKEYTABLE_H\n#define MKEYTABLE_H\n#include \"MKeyNames.h\"\n\n");
+    printf("#define MKEY_HASH_BUCKETS %zu\n", bucket_count);
+    printf("#define MKEY_HASH_SLOTS %zu\n\n", slot_count);
+
+    printf("static const uint16_t key_hash_displacement[MKEY_HASH_BUCKETS] = {");
+    for (size_t b = 0; b < bucket_count; b++)
+        printf("%s%u,", b % 12 ? " " : "\n    ", displacement[b]);
+    printf("\n};\n\n");
+
+    printf("static const MKeySlot key_hash_slots[MKEY_HASH_SLOTS] = {\n");
+    for (size_t s = 0; s < slot_count; s++) {
+        printf("    { ");
+        if (slots[s] < 0) printf("NULL, 0");
+        else {
+            print_literal(entries[slots[s]].name);
+            printf(", %d", entries[slots[s]].code);
+        }
+        printf(" },\n");
+    }
+    printf("};\n\n");
+
+    printf("static const char *const key_code_names[MKEY_MAX_CODE] = {\n");
+    for (int c = 0; c < MKEY_MAX_CODE; c++) {
+        printf("    /* %3d */ ", c);
+        if (code_names[c]) print_literal(code_names[c]);
+        else printf("NULL");
+        printf(",\n");
+    }
+    printf("};\n\n#endif\n");
+
+    free(bucket_sizes);
+    free(order);
+    free(displacement);
+    free(slots);
+    free(trial);
+    return 0;
+}